@@ -0,0 +1,26 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file CycleCounter.cpp
+/// \author Kai R. ()
+/// \brief Overflow interrupt of the cycle counter
+///
+/// \date 2025-06-29
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+// The library is compiled in every environment (lib_ldf_mode chain does not evaluate the
+// #ifdef around the include in main.cpp), but the object is only linked by the benchmark.
+#if defined(__AVR__)
+  #include "CycleCounter.hpp"
+
+namespace CycleCount {
+volatile uint16_t overflows {0};
+  #ifdef CYCLECOUNTER_TCB0
+void overflow() { ++overflows; }   // The interrupt of TCB0 is in PinTone.cpp
+  #endif
+}
+
+  #ifndef CYCLECOUNTER_TCB0
+ISR(TIMER1_OVF_vect) { ++CycleCount::overflows; }
+  #endif
+#endif
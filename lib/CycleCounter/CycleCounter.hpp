@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file CycleCounter.hpp
+/// \author Kai R. ()
+/// \brief CPU cycle counter for benchmarks (ATMega328: Timer 1, ATtiny: TCB0)
+///
+/// \date 2025-06-29
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+  // TCA0 is the millis() timer, so the counter borrows TCB0 from PinTone: its compare
+  // interrupt (PinTone.cpp) calls ToneTimer::hook, which counts the overflows.
+  #include "PinTone.hpp"
+  #define CYCLECOUNTER_TCB0
+#else
+  #include <avr/power.h>
+#endif
+
+namespace CycleCount {
+extern volatile uint16_t overflows;   // High word of the counter, counted by the interrupt in CycleCounter.cpp
+#ifdef CYCLECOUNTER_TCB0
+void overflow();                      // ToneTimer::hook while the counter runs
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief The timer counts every CPU clock (prescaler 1), the overflows extend it to 32 bits.
+///        ATMega328: Timer 1 is not used by the program and is switched off by
+///        SleepTicker::begin(), so begin() must be called afterwards.
+///        ATtiny: TCB0 runs from 0 to 0xFFFF. Every tone (PinTone::play()) takes the timer
+///        back, so nothing may sound while the counter is used.
+///        The counter stops in power down.
+///
+//////////////////////////////////////////////////////////////////////////////
+class CycleCounter {
+public:
+  void begin() {
+#ifdef CYCLECOUNTER_TCB0
+    ToneTimer::stop();
+    ToneTimer::hook = CycleCount::overflow;
+    TCB0.CTRLB = TCB_CNTMODE_INT_gc;
+    TCB0.CCMP = 0xFFFF;
+    TCB0.CNT = 0;
+    TCB0.INTFLAGS = TCB_CAPT_bm;
+    TCB0.INTCTRL = TCB_CAPT_bm;
+    TCB0.CTRLA = TCB_CLKSEL_CLKDIV1_gc | TCB_ENABLE_bm;
+#else
+    power_timer1_enable();
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    TCNT1 = 0;
+    TIFR1 = _BV(TOV1);
+    TIMSK1 = _BV(TOIE1);
+#endif
+    CycleCount::overflows = 0;
+    uint32_t start = now();
+    overhead = now() - start;
+  }
+
+  // Can also be called in an ISR
+  uint32_t now() const {
+    uint8_t sreg = SREG;
+    cli();
+#ifdef CYCLECOUNTER_TCB0
+    uint16_t low = TCB0.CNT;
+    bool overflow = TCB0.INTFLAGS & TCB_CAPT_bm;
+#else
+    uint16_t low = TCNT1;
+    bool overflow = TIFR1 & _BV(TOV1);
+#endif
+    uint16_t high = CycleCount::overflows;
+    if (overflow && low < 0x8000) { ++high; }   // Overflow not yet counted by the ISR
+    SREG = sreg;
+    return (static_cast<uint32_t>(high) << 16) | low;
+  }
+
+  // Cycles since start without the cycles of the measurement itself
+  uint32_t since(uint32_t start) const { return now() - start - overhead; }
+
+private:
+  uint32_t overhead {0};
+};
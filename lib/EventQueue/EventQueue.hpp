@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file EventQueue.hpp
+/// \author Kai R. ()
+/// \brief Lock-free ring buffer for passing events from an ISR to loop()
+///
+/// \date 2025-06-01
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Single-producer/single-consumer ring buffer.
+///        push() may only be called by the producer (e.g. an ISR) and
+///        pop()/clear() only by the consumer (e.g. loop()). Because head and tail are
+///        single bytes, no interrupt lock is necessary on an 8 bit controller.
+///        One element is kept free to distinguish between full and empty.
+///
+/// \tparam T  Type of the events
+/// \tparam N  Size of the buffer, must be a power of 2
+//////////////////////////////////////////////////////////////////////////////
+template <typename T, uint8_t N> class EventQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "The queue size must be a power of 2");
+
+public:
+  // Returns false if the queue is full and the event has been discarded.
+  bool push(const T& event) {
+    uint8_t h = head;
+    uint8_t next = (h + 1) & (N - 1);
+    if (next == tail) { return false; }
+    buffer[h] = event;
+    __asm__ __volatile__("" ::: "memory");   // The event must be written before the head is moved.
+    head = next;
+    return true;
+  }
+
+  // Returns false if the queue is empty.
+  bool pop(T& event) {
+    uint8_t t = tail;
+    if (t == head) { return false; }
+    event = buffer[t];
+    __asm__ __volatile__("" ::: "memory");   // The event must be read before the tail is moved.
+    tail = (t + 1) & (N - 1);
+    return true;
+  }
+
+  bool isEmpty() const { return head == tail; }
+  void clear() { tail = head; }
+
+private:
+  T buffer[N];
+  volatile uint8_t head {0};
+  volatile uint8_t tail {0};
+};
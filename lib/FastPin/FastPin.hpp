@@ -0,0 +1,113 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file FastPin.hpp
+/// \author Kai R. ()
+/// \brief Direct port access for pins known at compile time
+///
+/// \date 2025-07-27
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+//
+// The Arduino pin number is resolved to port and bit by the compiler. With a constant
+// register address and mask, read(), high(), low() and toggle() become single instructions
+// (sbis/sbic, sbi, cbi). digitalRead() and digitalWrite() look up the pin in three tables
+// in the flash memory at runtime and need about 50 cycles.
+//
+// ATtiny1604/1614 (megaTinyCore, 14 pins): 0 - 3 = PA4 - PA7, 4 - 7 = PB3 - PB0, 8 - 10 = PA1 - PA3, 11 = PA0
+// ATMega328: 0 - 7 = PORTD, 8 - 13 = PORTB, 14 - 19 = PORTC (A0 - A5)
+//
+// On the host (lib/NativeHal) the Arduino functions are used, so the simulation sees every pin access.
+//
+namespace fastpin {
+enum class Port : uint8_t { A, B, C, D };
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+constexpr uint8_t PIN_COUNT {12};
+
+constexpr Port portOf(uint8_t pin) { return (pin >= 4 && pin <= 7) ? Port::B : Port::A; }
+
+constexpr uint8_t bitOf(uint8_t pin) {
+  return (pin <= 3) ? pin + 4 : (pin <= 7) ? 7 - pin : (pin <= 10) ? pin - 7 : 0;
+}
+#else
+constexpr uint8_t PIN_COUNT {20};
+
+constexpr Port portOf(uint8_t pin) { return (pin <= 7) ? Port::D : (pin <= 13) ? Port::B : Port::C; }
+
+constexpr uint8_t bitOf(uint8_t pin) { return (pin <= 7) ? pin : (pin <= 13) ? pin - 8 : pin - 14; }
+#endif
+}   // namespace fastpin
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Pin with port and bit mask resolved at compile time. All functions are static,
+///        e.g. FastPin<PIN_ALARM>::toggle();
+///
+/// \tparam PIN  Arduino pin number
+//////////////////////////////////////////////////////////////////////////////
+template <uint8_t PIN> class FastPin {
+  static_assert(PIN < fastpin::PIN_COUNT, "The pin is not part of the pin map");
+
+public:
+  static constexpr fastpin::Port PORT {fastpin::portOf(PIN)};
+  static constexpr uint8_t MASK {static_cast<uint8_t>(1 << fastpin::bitOf(PIN))};
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+  static void output() { vport().DIR |= MASK; }
+  static void input() {
+    vport().DIR &= ~MASK;
+    ctrl() &= ~PORT_PULLUPEN_bm;
+  }
+  static void inputPullup() {
+    vport().DIR &= ~MASK;
+    ctrl() |= PORT_PULLUPEN_bm;
+  }
+  static bool read() { return vport().IN & MASK; }
+  static void high() { vport().OUT |= MASK; }
+  static void low() { vport().OUT &= ~MASK; }
+  static void toggle() { port().OUTTGL = MASK; }
+
+private:
+  // The virtual ports are in the I/O space (sbi, cbi, sbis), OUTTGL and PINnCTRL are not
+  static VPORT_t& vport() { return (PORT == fastpin::Port::A) ? VPORTA : VPORTB; }
+  static PORT_t& port() { return (PORT == fastpin::Port::A) ? PORTA : PORTB; }
+  static volatile uint8_t& ctrl() { return (&port().PIN0CTRL)[fastpin::bitOf(PIN)]; }
+#elif defined(__AVR__)
+  static void output() { ddr() |= MASK; }
+  static void input() {
+    ddr() &= ~MASK;
+    out() &= ~MASK;
+  }
+  static void inputPullup() {
+    ddr() &= ~MASK;
+    out() |= MASK;
+  }
+  static bool read() { return in() & MASK; }
+  static void high() { out() |= MASK; }
+  static void low() { out() &= ~MASK; }
+  static void toggle() { in() = MASK; }   // Writing a 1 to PINx toggles the output
+
+private:
+  static volatile uint8_t& in() {
+    return (PORT == fastpin::Port::B) ? PINB : (PORT == fastpin::Port::C) ? PINC : PIND;
+  }
+  static volatile uint8_t& ddr() {
+    return (PORT == fastpin::Port::B) ? DDRB : (PORT == fastpin::Port::C) ? DDRC : DDRD;
+  }
+  static volatile uint8_t& out() {
+    return (PORT == fastpin::Port::B) ? PORTB : (PORT == fastpin::Port::C) ? PORTC : PORTD;
+  }
+#else
+  static void output() { pinMode(PIN, OUTPUT); }
+  static void input() { pinMode(PIN, INPUT); }
+  static void inputPullup() { pinMode(PIN, INPUT_PULLUP); }
+  static bool read() { return digitalRead(PIN) == HIGH; }
+  static void high() { digitalWrite(PIN, HIGH); }
+  static void low() { digitalWrite(PIN, LOW); }
+  static void toggle() { digitalWrite(PIN, !read()); }
+#endif
+};
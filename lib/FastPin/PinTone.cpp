@@ -0,0 +1,26 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file PinTone.cpp
+/// \author Kai R. ()
+/// \brief Compare interrupt of the PinTone timer
+///
+/// \date 2025-07-27
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "PinTone.hpp"
+
+#if defined(__AVR__)
+namespace ToneTimer {
+void (*volatile hook)() {nullptr};
+}
+
+  #if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+ISR(TCB0_INT_vect) {
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  ToneTimer::hook();
+}
+  #else
+ISR(TIMER2_COMPA_vect) { ToneTimer::hook(); }
+  #endif
+#endif
@@ -0,0 +1,143 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file PinTone.hpp
+/// \author Kai R. ()
+/// \brief Square wave on a pin known at compile time, replaces tone() and noTone()
+///
+/// \date 2025-07-27
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include "FastPin.hpp"
+
+//
+// ATtiny: TCB0 in periodic interrupt mode (like tone() of megaTinyCore)
+// ATMega328: Timer 2 in CTC mode (like tone() of the Arduino core)
+//
+// The compare interrupt toggles the pin with FastPin, instead of looking up the pin and its
+// port registers as tone() does. The buzzer pin is not an output of the timer, so the
+// interrupt is necessary. Because tone() is no longer called, the core does not link its
+// own interrupt for the timer.
+//
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+  #if defined(MILLIS_USE_TIMERB0)
+    #error "PinTone needs TCB0, select another millis() timer"
+  #endif
+#endif
+
+#if defined(__AVR__)
+namespace ToneTimer {
+extern void (*volatile hook)();   // Called by the compare interrupt (PinTone.cpp)
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+// With CLK/2, CCMP holds at most 65536 clocks per half wave: 62Hz at 16MHz, 77Hz at 20MHz.
+// Lower pitches (note::b0 - note::b1) are raised to this frequency by PinTone::play().
+constexpr unsigned int MIN_FREQUENCY {(F_CPU + 262143) / 262144};
+
+// frequency >= MIN_FREQUENCY
+inline void start(unsigned int frequency) {
+  uint32_t counts = F_CPU / 2 / frequency;   // Timer clocks per half wave
+  uint8_t clksel = TCB_CLKSEL_CLKDIV1_gc;
+  if (counts > 0xFFFF) {
+    counts /= 2;
+    clksel = TCB_CLKSEL_CLKDIV2_gc;
+  }
+  TCB0.CTRLA = 0;
+  TCB0.CTRLB = TCB_CNTMODE_INT_gc;
+  TCB0.CCMP = counts - 1;
+  TCB0.CNT = 0;
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  TCB0.INTCTRL = TCB_CAPT_bm;
+  TCB0.CTRLA = clksel | TCB_ENABLE_bm;
+}
+
+inline void stop() {
+  TCB0.CTRLA = 0;
+  TCB0.INTCTRL = 0;
+}
+#else
+// With the prescaler 1024, OCR2A holds at most 262144 clocks per half wave: 31Hz at 16MHz,
+// 16Hz at 8MHz. Lower pitches are raised to this frequency by PinTone::play().
+constexpr unsigned int MIN_FREQUENCY {(F_CPU + 524287) / 524288};
+
+// frequency >= MIN_FREQUENCY
+inline void start(unsigned int frequency) {
+  constexpr uint8_t PRESCALER_SHIFT[] {0, 3, 5, 6, 7, 8, 10};   // Clock select 1 - 7 of timer 2
+  uint32_t counts = F_CPU / 2 / frequency;                      // Timer clocks per half wave
+  uint8_t cs = 1;
+  while (cs < 7 && (counts >> PRESCALER_SHIFT[cs - 1]) > 256) { ++cs; }
+  TIMSK2 = 0;
+  TCCR2A = _BV(WGM21);
+  TCCR2B = cs;
+  TCNT2 = 0;
+  OCR2A = (counts >> PRESCALER_SHIFT[cs - 1]) - 1;
+  TIFR2 = _BV(OCF2A);
+  TIMSK2 = _BV(OCIE2A);
+}
+
+inline void stop() {
+  TIMSK2 = 0;
+  TCCR2B = 0;
+}
+#endif
+}   // namespace ToneTimer
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Square wave for a buzzer. Only one pin can sound at a time, the last call to
+///        play() wins. Can also be called from an interrupt (TimedToneSequence).
+///
+/// \tparam PIN  where the buzzer is connected to.
+//////////////////////////////////////////////////////////////////////////////
+template <uint8_t PIN> class PinTone {
+public:
+  // duration 0 = until stop(). frequency * duration / 500 is limited to 65535 half waves,
+  // e.g. 6.5s at 5kHz. Frequencies below ToneTimer::MIN_FREQUENCY sound at that frequency.
+  static void play(unsigned int frequency, uint16_t duration = 0) {
+#if defined(__AVR__)
+    ToneTimer::stop();
+    if (!frequency) {
+      FastPin<PIN>::low();
+      return;
+    }
+    if (frequency < ToneTimer::MIN_FREQUENCY) { frequency = ToneTimer::MIN_FREQUENCY; }
+    uint32_t halfWaves = static_cast<uint32_t>(frequency) * duration / 500;
+    toggles = (halfWaves > 0xFFFF) ? 0xFFFF : (duration && !halfWaves) ? 1 : halfWaves;
+    FastPin<PIN>::output();
+    ToneTimer::hook = toggle;
+    ToneTimer::start(frequency);
+#else
+    (frequency) ? tone(PIN, frequency, duration) : noTone(PIN);
+#endif
+  }
+
+  static void stop() {
+#if defined(__AVR__)
+    ToneTimer::stop();
+    FastPin<PIN>::low();
+#else
+    noTone(PIN);
+#endif
+  }
+
+private:
+#if defined(__AVR__)
+  // Compare interrupt
+  static void toggle() {
+    FastPin<PIN>::toggle();
+    if (toggles && !--toggles) {
+      ToneTimer::stop();
+      FastPin<PIN>::low();
+    }
+  }
+
+  static volatile uint16_t toggles;   // Remaining half waves, 0 = endless
+#endif
+};
+
+#if defined(__AVR__)
+template <uint8_t PIN> volatile uint16_t PinTone<PIN>::toggles {0};
+#endif   // The compare interrupt is in PinTone.cpp
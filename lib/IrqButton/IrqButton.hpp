@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file IrqButton.hpp
+/// \author Kai R. ()
+/// \brief Button driver with pin interrupt and debouncing in the timer interrupt
+///
+/// \date 2025-07-20
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include "EventQueue.hpp"
+#include "FastPin.hpp"
+#include "MilliTick.hpp"
+
+enum class ButtonEvent : uint8_t { shortPress, longPress };
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Button (pin to GND) without polling by loop(). The pin interrupt (both edges)
+///        notes the time of the edge and switches on the MilliTick interrupt, in which an
+///        integrating debouncer follows the pin level: every tick with the pin low counts
+///        up, every tick with the pin high counts down. A level is only accepted when the
+///        integrator reaches its limit, so bounces and spikes are filtered out.
+///        The press is classified in the interrupt as well: long as soon as it is held
+///        for the long press time, short if it is released before. The events are queued
+///        and onEvent is called. When the button is released and stable again, the tick is
+///        switched off. The pin interrupt is also the wake up source for the sleep modes.
+///
+///        edge() must be called by the pin interrupt and tick() by the hook
+///        MilliTick::hooks[MilliTick::button].
+///
+/// \tparam PIN  Button pin, read with FastPin in the tick
+//////////////////////////////////////////////////////////////////////////////
+template <uint8_t PIN> class IrqButton {
+public:
+  static constexpr uint8_t INTEGRATOR {5};   // Ticks (about 1ms) of stable level until it is accepted
+
+  explicit IrqButton(uint16_t longPressMs) : longTicks {MilliTick::fromMillis(longPressMs)} {}
+
+  void begin() { FastPin<PIN>::inputPullup(); }
+
+  // Pin interrupt
+  void edge() {
+    lastEdge = ticks;
+    if (!active) {
+      active = true;
+      MilliTick::enableFromIsr(MilliTick::button);
+    }
+  }
+
+  // MilliTick interrupt
+  void tick();
+
+  bool pop(ButtonEvent& event) { return events.pop(event); }
+  bool isActive() const { return active; }   // Debouncing or pressed, the tick is running
+  bool isPressed() const { return pressed; }
+  // The current press produces no event, e.g. the press that has woken up the controller
+  void ignorePress() { ignore = pressed; }
+
+  void (*volatile onEvent)() {nullptr};   // Called in the interrupt when an event has been queued
+
+private:
+  void emit(ButtonEvent event) {
+    if (!ignore && events.push(event) && onEvent) { onEvent(); }
+  }
+
+  const uint16_t longTicks;
+  EventQueue<ButtonEvent, 4> events;
+  volatile uint16_t ticks {0};      // Only counts while the tick is running
+  volatile uint16_t lastEdge {0};   // Tick of the last edge, the start of a press
+  uint16_t pressStart {0};
+  uint8_t integrator {0};
+  volatile bool active {false};
+  volatile bool pressed {false};
+  volatile bool ignore {false};
+  bool longReported {false};
+};
+
+template <uint8_t PIN> void IrqButton<PIN>::tick() {
+  ++ticks;
+  if (!FastPin<PIN>::read()) {
+    if (integrator < INTEGRATOR) { ++integrator; }
+  } else if (integrator > 0) {
+    --integrator;
+  }
+
+  if (!pressed && integrator == INTEGRATOR) {
+    pressed = true;
+    longReported = false;
+    pressStart = lastEdge;
+  } else if (pressed && integrator == 0) {
+    pressed = false;
+    if (!longReported) { emit(ButtonEvent::shortPress); }
+    ignore = false;
+  }
+  if (pressed && !longReported && static_cast<uint16_t>(ticks - pressStart) >= longTicks) {
+    longReported = true;
+    emit(ButtonEvent::longPress);
+  }
+  if (!pressed && integrator == 0) {
+    active = false;
+    MilliTick::disableFromIsr(MilliTick::button);
+  }
+}
@@ -0,0 +1,17 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file KitchenTimer.cpp
+/// \author Kai R. ()
+/// \brief Objects of KitchenTimer.hpp, defined once for all translation units
+///
+/// \date 2025-09-21
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "KitchenTimer.hpp"
+
+TickClock tickBase;
+
+namespace TimerState {
+void (*hook)(const KitchenTimer&) {nullptr};
+}
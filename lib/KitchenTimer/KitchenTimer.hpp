@@ -0,0 +1,151 @@
+#ifndef KITCHENTIMER_HPP
+#define KITCHENTIMER_HPP
+
+#include <Arduino.h>
+constexpr uint8_t TIMEUNIT_SEC{1};
+constexpr uint8_t TIMEUNIT_MIN{60};
+constexpr uint8_t MAX_SECONDS{59};
+constexpr uint8_t MAX_MINUTES{60};
+constexpr int MAX_TOTALSECONDS{MAX_MINUTES * TIMEUNIT_MIN};
+
+enum class KitchenTimerState : uint8_t { off = 0, active, alarm };
+enum class ActiveUnit : uint8_t { seconds, minutes };
+
+// Periods for the countdown are given in 1/256 ms (fixed point 24.8). This allows the
+// oscillator to be compensated finer than 1 ms without any float arithmetic.
+constexpr uint8_t PERIOD_FRACTION_BITS{8};
+constexpr uint32_t periodQ8(uint16_t ms, uint8_t fraction = 0) {
+  return (static_cast<uint32_t>(ms) << PERIOD_FRACTION_BITS) | fraction;
+}
+
+// Returns true once per period. The next deadline is always calculated from the previous
+// deadline and not from the time of the call, so a late loop pass does not shift the countdown.
+// If the loop is late by more than one period, the missed ticks are delivered on the following calls.
+class TickClock {
+public:
+  boolean operator()(const uint32_t period);
+  // Time (millis()) at which the next tick is due
+  uint32_t next(const uint32_t period) const { return timeStamp + ((period + fraction) >> PERIOD_FRACTION_BITS); }
+  void start() {
+    timeStamp = millis();
+    fraction = 0;
+  }
+
+private:
+  uint32_t timeStamp{0};   // Deadline of the last tick, the next one is timeStamp + period
+  uint8_t fraction{0};      // Accumulated sub millisecond part of the period
+};
+
+// Shared time base of all kitchen timers (KitchenTimer.cpp)
+extern TickClock tickBase;
+
+class KitchenTimer;
+namespace TimerState {
+// Called after the state of a timer has changed, e.g. for a trace (lib/TraceRing)
+extern void (*hook)(const KitchenTimer&);
+}
+
+// The timer needs 4 bytes: the time (max. 3600s) fits into 12 bits, state and unit are stored in
+// the remaining bits. The multiplier for in-/decrementing results from the unit, so only 16 bit
+// arithmetic is necessary.
+class KitchenTimer {
+public:
+  KitchenTimer(size_t m = 0, size_t s = 0)
+      : totalSeconds{0}, state{static_cast<uint8_t>(KitchenTimerState::off)},
+        activeUnit{static_cast<uint8_t>(ActiveUnit::seconds)} {
+    setMinutes(m);
+    setSeconds(s);
+  }
+
+  KitchenTimer &operator--();
+  KitchenTimer const operator--(int);
+  KitchenTimer &operator++();
+  KitchenTimer const operator++(int);
+  boolean operator()(const uint32_t period) { return tickBase(period); }
+
+  void start() { tickBase.start(); }
+  size_t getMinutes() const { return totalSeconds / TIMEUNIT_MIN; }
+  size_t getSeconds() const { return totalSeconds % TIMEUNIT_MIN; }
+  void setMinutes(size_t m);
+  void setSeconds(size_t s);
+  void setTotalSeconds(uint16_t s) { totalSeconds = (s > MAX_TOTALSECONDS) ? MAX_TOTALSECONDS : s; }
+  uint16_t getTotalSeconds() const { return totalSeconds; }
+  void setUnitSeconds() { activeUnit = static_cast<uint8_t>(ActiveUnit::seconds); }
+  void setUnitMinutes() { activeUnit = static_cast<uint8_t>(ActiveUnit::minutes); }
+  bool timeIsUp() const { return !(totalSeconds); }
+
+  void setState(KitchenTimerState s) {
+    if (s == getState()) { return; }
+    state = static_cast<uint8_t>(s);
+    if (TimerState::hook) { TimerState::hook(*this); }
+  }
+  KitchenTimerState getState() const { return static_cast<KitchenTimerState>(state); }
+  ActiveUnit getActiveUnit() const { return static_cast<ActiveUnit>(activeUnit); }
+
+  // Tick of the shared time base at which a running timer expires (see KitchenTimerPool)
+  void setExpiry(uint16_t tick) { expiry = tick; }
+  uint16_t getExpiry() const { return expiry; }
+
+private:
+  uint8_t multiplier() const {
+    return (activeUnit == static_cast<uint8_t>(ActiveUnit::minutes)) ? TIMEUNIT_MIN : TIMEUNIT_SEC;
+  }
+
+  uint16_t totalSeconds : 12;
+  uint16_t state : 2;        // KitchenTimerState
+  uint16_t activeUnit : 1;   // ActiveUnit
+  uint16_t expiry{0};
+};
+static_assert(sizeof(KitchenTimer) == 4, "KitchenTimer must fit into 4 bytes");
+static_assert(MAX_TOTALSECONDS < 4096, "The time must fit into 12 bits");
+
+inline boolean TickClock::operator()(const uint32_t period) {
+  uint32_t next = period + fraction;
+  if (millis() - timeStamp < (next >> PERIOD_FRACTION_BITS)) { return false; }
+  timeStamp += next >> PERIOD_FRACTION_BITS;
+  fraction = static_cast<uint8_t>(next);
+  return true;
+}
+
+inline void KitchenTimer::setMinutes(size_t m) {
+  uint16_t minutes = ((m > MAX_MINUTES) ? MAX_MINUTES : TIMEUNIT_MIN) * m;
+  minutes += totalSeconds % TIMEUNIT_MIN;
+  totalSeconds = (minutes > MAX_TOTALSECONDS) ? MAX_TOTALSECONDS : minutes;
+}
+
+inline void KitchenTimer::setSeconds(size_t s) {
+  uint16_t seconds = (totalSeconds / TIMEUNIT_MIN) * TIMEUNIT_MIN;
+  totalSeconds = seconds + ((s > MAX_SECONDS) ? MAX_SECONDS : (seconds == MAX_TOTALSECONDS) ? 0 : s);
+}
+
+// pre decrement (--x)
+inline KitchenTimer &KitchenTimer::operator--() {
+  uint16_t save = totalSeconds;
+  uint8_t m = multiplier();
+  uint16_t seconds = save - m;
+  // Unsigned overflow if negative! (thats why ">" and not "<")
+  totalSeconds = (seconds > MAX_TOTALSECONDS) ? ((m == TIMEUNIT_SEC) ? 0 : save % TIMEUNIT_MIN) : seconds;
+  return *this;
+}
+
+// post decrement (x--)
+inline KitchenTimer const KitchenTimer::operator--(int) {
+  KitchenTimer temp{*this};
+  operator--();
+  return temp;
+}
+
+// pre increment (++x)
+inline KitchenTimer &KitchenTimer::operator++() {
+  uint16_t seconds = totalSeconds + multiplier();
+  totalSeconds = (seconds > MAX_TOTALSECONDS) ? MAX_TOTALSECONDS : seconds;
+  return *this;
+}
+
+// post increment (x++)
+inline KitchenTimer const KitchenTimer::operator++(int) {
+  KitchenTimer temp{*this};
+  operator++();
+  return temp;
+}
+#endif
\ No newline at end of file
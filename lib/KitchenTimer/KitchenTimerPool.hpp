@@ -0,0 +1,148 @@
+#ifndef KITCHENTIMERPOOL_HPP
+#define KITCHENTIMERPOOL_HPP
+
+#include <Arduino.h>
+#include "KitchenTimer.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Fixed number of kitchen timers that count down on a shared time base.
+///
+/// All running timers are counted in the same seconds (tick). For every running timer
+/// the tick at which its time is up is stored. The running timers are kept in a binary
+/// min-heap ordered by this tick, so the next expiring timer is always heap[0]:
+/// checking for an expired timer is O(1), removing it O(log n).
+/// The remaining time of a running timer is only calculated when it is displayed.
+///
+/// RAM per timer: 4 bytes KitchenTimer (incl. the expiry tick) + 1 byte heap entry.
+///
+/// \tparam N  Number of timers (max. 8)
+//////////////////////////////////////////////////////////////////////////////
+template <uint8_t N> class KitchenTimerPool {
+  static_assert(N > 0 && N <= 8, "1 to 8 timers are supported");
+
+public:
+  static constexpr int8_t NONE {-1};
+
+  KitchenTimer &operator[](uint8_t i) { return timers[i]; }
+  KitchenTimer &current() { return timers[view]; }
+  uint8_t getCurrent() const { return view; }
+  uint8_t indexOf(const KitchenTimer& t) const { return &t - timers; }
+  void setCurrent(uint8_t i) {
+    view = i;
+    sync(i);
+  }
+  void selectNext() { setCurrent((view + 1) % N); }
+
+  bool isRunning() const { return heapSize > 0; }
+  // Returns true once per period while a timer is running.
+  boolean operator()(const uint32_t period) { return tickBase(period); }
+  uint32_t nextTick(const uint32_t period) const { return tickBase.next(period); }
+
+  void start(uint8_t i);
+  void stop(uint8_t i);
+  void tick();
+  int8_t popExpired();
+  // The running timer whose time is up next
+  int8_t nextExpiring() const { return isRunning() ? heap[0] : NONE; }
+  int8_t find(KitchenTimerState s) const;
+
+private:
+  bool earlier(uint8_t a, uint8_t b) const {
+    return static_cast<int16_t>(timers[a].getExpiry() - timers[b].getExpiry()) < 0;
+  }
+  void sync(uint8_t i) {
+    if (timers[i].getState() == KitchenTimerState::active) { timers[i].setTotalSeconds(timers[i].getExpiry() - now); }
+  }
+  void siftUp(uint8_t pos);
+  void siftDown(uint8_t pos);
+  void removeAt(uint8_t pos);
+
+  KitchenTimer timers[N];
+  uint8_t heap[N];      // Indices of the running timers
+  uint8_t heapSize{0};
+  uint16_t now{0};      // Shared tick (seconds)
+  uint8_t view{0};      // Displayed timer
+};
+
+// The timer counts down from its set time. The first running timer starts the shared clock,
+// all others are aligned to its seconds.
+template <uint8_t N> void KitchenTimerPool<N>::start(uint8_t i) {
+  if (timers[i].getState() == KitchenTimerState::active) { return; }
+  if (!isRunning()) { tickBase.start(); }
+  timers[i].setState(KitchenTimerState::active);
+  timers[i].setUnitSeconds();
+  timers[i].setExpiry(now + timers[i].getTotalSeconds());
+  heap[heapSize] = i;
+  siftUp(heapSize++);
+}
+
+template <uint8_t N> void KitchenTimerPool<N>::stop(uint8_t i) {
+  if (timers[i].getState() == KitchenTimerState::active) {
+    sync(i);
+    for (uint8_t pos = 0; pos < heapSize; ++pos) {
+      if (heap[pos] == i) {
+        removeAt(pos);
+        break;
+      }
+    }
+  }
+  timers[i].setState(KitchenTimerState::off);
+}
+
+// One second has elapsed
+template <uint8_t N> void KitchenTimerPool<N>::tick() {
+  ++now;
+  sync(view);
+}
+
+// Returns the index of a timer whose time is up (its state is set to alarm), or NONE.
+// Must be called until NONE is returned, as several timers can expire with the same tick.
+template <uint8_t N> int8_t KitchenTimerPool<N>::popExpired() {
+  if (!isRunning() || static_cast<int16_t>(now - timers[heap[0]].getExpiry()) < 0) { return NONE; }
+  uint8_t i = heap[0];
+  removeAt(0);
+  timers[i].setTotalSeconds(0);
+  timers[i].setState(KitchenTimerState::alarm);
+  return i;
+}
+
+template <uint8_t N> int8_t KitchenTimerPool<N>::find(KitchenTimerState s) const {
+  for (uint8_t i = 0; i < N; ++i) {
+    if (timers[i].getState() == s) { return i; }
+  }
+  return NONE;
+}
+
+template <uint8_t N> void KitchenTimerPool<N>::siftUp(uint8_t pos) {
+  while (pos > 0) {
+    uint8_t parent = (pos - 1) / 2;
+    if (!earlier(heap[pos], heap[parent])) { break; }
+    uint8_t tmp = heap[pos];
+    heap[pos] = heap[parent];
+    heap[parent] = tmp;
+    pos = parent;
+  }
+}
+
+template <uint8_t N> void KitchenTimerPool<N>::siftDown(uint8_t pos) {
+  for (;;) {
+    uint8_t smallest = pos;
+    uint8_t child = 2 * pos + 1;
+    if (child < heapSize && earlier(heap[child], heap[smallest])) { smallest = child; }
+    if (child + 1 < heapSize && earlier(heap[child + 1], heap[smallest])) { smallest = child + 1; }
+    if (smallest == pos) { break; }
+    uint8_t tmp = heap[pos];
+    heap[pos] = heap[smallest];
+    heap[smallest] = tmp;
+    pos = smallest;
+  }
+}
+
+template <uint8_t N> void KitchenTimerPool<N>::removeAt(uint8_t pos) {
+  heap[pos] = heap[--heapSize];
+  if (pos < heapSize) {
+    siftDown(pos);
+    siftUp(pos);
+  }
+}
+#endif
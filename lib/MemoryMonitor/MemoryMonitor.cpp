@@ -0,0 +1,31 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file MemoryMonitor.cpp
+/// \author Kai R. ()
+/// \brief Stack painting at the start (section .init1)
+///
+/// \date 2025-08-03
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryMonitor.hpp"
+
+#if defined(__AVR__)
+namespace memory {
+// Runs before the stack pointer and r1 (zero) are initialized, therefore in assembler
+void paintStack() __attribute__((naked, used, section(".init1")));
+void paintStack() {
+  __asm volatile(
+      "    ldi r30, lo8(_end)\n"
+      "    ldi r31, hi8(_end)\n"
+      "    ldi r24, %[canary]\n"
+      "    ldi r25, hi8(__stack)\n"
+      "    rjmp 2f\n"
+      "1:  st Z+, r24\n"
+      "2:  cpi r30, lo8(__stack)\n"
+      "    cpc r31, r25\n"
+      "    brlo 1b\n"
+      "    breq 1b\n" ::[canary] "M"(CANARY));
+}
+}   // namespace memory
+#endif
@@ -0,0 +1,100 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file MemoryMonitor.hpp
+/// \author Kai R. ()
+/// \brief RAM usage at runtime: static data, heap, stack and its high-water mark
+///
+/// \date 2025-08-03
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+//
+// Before the RAM is initialized (section .init1), everything between the end of the static
+// data (_end) and the top of the RAM (__stack) is filled with CANARY. The stack grows
+// downwards from __stack, the heap upwards from _end. The bytes that still contain CANARY
+// have never been used, so the smallest distance between heap and stack since the start
+// can be found at any time without measuring in every function.
+//
+// The linker symbols only exist on the controller, on the host (lib/NativeHal) all values are 0.
+//
+namespace memory {
+constexpr uint8_t CANARY {0xC5};
+
+struct Usage {
+  uint16_t total;       // RAM of the controller
+  uint16_t data;        // Initialized static variables (.data)
+  uint16_t bss;         // Zero initialized static variables (.bss)
+  uint16_t heap;        // malloc(), 0 if it is not linked
+  uint16_t stack;       // Current depth
+  uint16_t stackMax;    // High-water mark since the start
+  uint16_t neverUsed;   // Bytes between heap and stack that still contain CANARY
+};
+
+#if defined(__AVR__)
+extern "C" {
+extern uint8_t __data_start;
+extern uint8_t __data_end;
+extern uint8_t __bss_start;
+extern uint8_t __bss_end;
+extern uint8_t __heap_start;
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t* __brkval __attribute__((weak));   // Only defined if malloc() is linked
+}
+
+// paintStack() in MemoryMonitor.cpp fills the RAM between the static data and the stack with
+// CANARY before main() runs.
+
+inline Usage usage() {
+  uint8_t marker;
+  const uint8_t* heapEnd = (&__brkval && __brkval) ? __brkval : &__heap_start;
+  const uint8_t* p = heapEnd;
+  while (p <= &__stack && *p == CANARY) { ++p; }
+  Usage u;
+  u.total = &__stack + 1 - &__data_start;
+  u.data = &__data_end - &__data_start;
+  u.bss = &__bss_end - &__bss_start;
+  u.heap = heapEnd - &__heap_start;
+  u.stack = &__stack - &marker;   // The stack pointer is just below the local variable
+  u.stackMax = &__stack + 1 - p;
+  u.neverUsed = p - heapEnd;
+  return u;
+}
+#else
+inline Usage usage() { return {0, 0, 0, 0, 0, 0, 0}; }
+#endif
+
+// Output in one line, e.g. to Serial
+template <typename Out> void print(Out& out) {
+  Usage u {usage()};
+  out.print(F("RAM "));
+  out.print(u.total);
+  out.print(F(" data "));
+  out.print(u.data);
+  out.print(F(" bss "));
+  out.print(u.bss);
+  out.print(F(" heap "));
+  out.print(u.heap);
+  out.print(F(" stack "));
+  out.print(u.stack);
+  out.print(F(" max "));
+  out.print(u.stackMax);
+  out.print(F(" never used "));
+  out.println(u.neverUsed);
+}
+
+// Size of a static object, see MEMORY_OBJECT
+template <typename Out, typename Name> void printObject(Out& out, Name name, size_t size) {
+  out.print(F("  "));
+  out.print(name);
+  out.print(' ');
+  out.println(static_cast<unsigned int>(size));
+}
+}   // namespace memory
+
+// Prints name and size of a global object, e.g. MEMORY_OBJECT(Serial, u8g2);
+#define MEMORY_OBJECT(out, object) memory::printObject(out, F(#object), sizeof(object))
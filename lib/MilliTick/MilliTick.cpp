@@ -0,0 +1,25 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file MilliTick.cpp
+/// \author Kai R. ()
+/// \brief Timer interrupt of the MilliTick users
+///
+/// \date 2025-07-20
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "MilliTick.hpp"
+
+namespace MilliTick {
+void (*volatile hooks[USERS])() {};
+volatile uint8_t users {0};
+}   // namespace MilliTick
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+ISR(RTC_PIT_vect) {
+  RTC.PITINTFLAGS = RTC_PI_bm;
+  MilliTick::run();
+}
+#else
+ISR(TIMER0_COMPA_vect) { MilliTick::run(); }
+#endif
@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file MilliTick.hpp
+/// \author Kai R. ()
+/// \brief Timer interrupt of about 1ms, shared by the melody and the button
+///
+/// \date 2025-07-20
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+//
+// ATtiny: RTC periodic interrupt, 32768Hz / 32 = 1024 ticks per second (also in standby)
+// ATMega328: Compare A of the millis() timer 0, F_CPU / 64 / 256 ticks per second
+//
+// Each user has its own hook and switches the interrupt on and off independently. The timer
+// interrupt only runs as long as at least one user needs it.
+//
+namespace MilliTick {
+enum User : uint8_t { tone = 0, button, USERS };
+
+extern void (*volatile hooks[USERS])();   // Called by the timer interrupt while the user is enabled
+extern volatile uint8_t users;            // One bit per enabled user
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+inline uint16_t fromMillis(uint32_t ms) { return ms * 128 / 125; }
+
+inline void start() {
+  if (RTC.CLKSEL != RTC_CLKSEL_INT32K_gc) { RTC.CLKSEL = RTC_CLKSEL_INT32K_gc; }
+  while (RTC.PITSTATUS > 0) {}
+  RTC.PITINTCTRL = RTC_PI_bm;
+  RTC.PITCTRLA = RTC_PERIOD_CYC32_gc | RTC_PITEN_bm;
+}
+
+inline void stop() {
+  while (RTC.PITSTATUS > 0) {}
+  RTC.PITCTRLA = 0;
+  RTC.PITINTCTRL = 0;
+}
+#else
+inline uint16_t fromMillis(uint32_t ms) { return ms * (F_CPU / 1000) / (64UL * 256); }
+
+inline void start() {
+  OCR0A = 128;   // Any value, timer 0 runs freely for millis()
+  TIFR0 = _BV(OCF0A);
+  TIMSK0 |= _BV(OCIE0A);
+}
+
+inline void stop() { TIMSK0 &= ~_BV(OCIE0A); }
+#endif
+
+// Only with disabled interrupts, e.g. in an ISR
+inline void enableFromIsr(User u) {
+  if (!users) { start(); }
+  users |= 1 << u;
+}
+
+inline void disableFromIsr(User u) {
+  users &= ~(1 << u);
+  if (!users) { stop(); }
+}
+
+inline void enable(User u) {
+  noInterrupts();
+  enableFromIsr(u);
+  interrupts();
+}
+
+inline void disable(User u) {
+  noInterrupts();
+  disableFromIsr(u);
+  interrupts();
+}
+
+inline void run() {
+  uint8_t active = users;
+  for (uint8_t u = 0; u < USERS; ++u) {
+    if ((active & (1 << u)) && hooks[u]) { hooks[u](); }
+  }
+}
+}   // namespace MilliTick
+
+// The objects and the timer interrupt are in MilliTick.cpp
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file Arduino.h
+/// \author Kai R. ()
+/// \brief The part of the Arduino API used by the program, for the host-native build.
+///        Time, pins and tones are provided by the simulation in NativeHal.hpp.
+///
+/// \date 2025-06-22
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#ifndef F_CPU
+  #define F_CPU 16000000UL   // Like the Nano, the timer 0 interrupt depends on it
+#endif
+
+using byte = uint8_t;
+using boolean = bool;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))   // INT0 and INT1
+// Pin change interrupts as in pins_arduino.h of the standard variant
+#define digitalPinToPCICR(p) (((p) >= 0 && (p) <= 21) ? (&PCICR) : ((volatile uint8_t*)0))
+#define digitalPinToPCICRbit(p) (((p) <= 7) ? 2 : (((p) <= 13) ? 0 : 1))
+#define digitalPinToPCMSK(p) (((p) <= 7) ? (&PCMSK2) : (((p) <= 13) ? (&PCMSK0) : (((p) <= 21) ? (&PCMSK1) : ((volatile uint8_t*)0))))
+#define digitalPinToPCMSKbit(p) (((p) <= 7) ? (p) : (((p) <= 13) ? ((p) - 8) : ((p) - 14)))
+
+#define SDA 18
+#define SCL 19
+#define LED_BUILTIN 13
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+
+#define F(s) (s)
+
+// millis() has 32 bits like on the controller, so that overflows behave the same
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(unsigned int us);
+void yield();   // Busy waits call it, it advances the virtual time by 1us
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+void attachInterrupt(int8_t interruptNum, void (*isr)(), int mode);
+void detachInterrupt(int8_t interruptNum);
+void interrupts();
+void noInterrupts();
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+class HardwareSerial {
+public:
+  void begin(unsigned long) {}
+  void end() {}
+  void flush() {}
+  int available();
+  int read();
+
+  size_t print(const char* s);
+  size_t print(char c);
+  size_t print(long n);
+  size_t print(unsigned long n);
+  size_t print(int n) { return print(static_cast<long>(n)); }
+  size_t print(unsigned int n) { return print(static_cast<unsigned long>(n)); }
+  size_t print(unsigned char n) { return print(static_cast<unsigned long>(n)); }
+  template <typename T> size_t println(T v) { return print(v) + println(); }
+  size_t println() { return print('\n'); }
+  size_t write(uint8_t c) { return print(static_cast<char>(c)); }
+};
+
+extern HardwareSerial Serial;
+
+// Arduino sketch
+void setup();
+void loop();
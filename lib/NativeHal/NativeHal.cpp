@@ -0,0 +1,544 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file NativeHal.cpp
+/// \author Kai R. ()
+/// \brief Simulated ATMega328 for running the program on the host (env:native)
+///
+/// \date 2025-06-22
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "NativeHal.hpp"
+#include <U8g2lib.h>
+#include <avr/eeprom.h>
+#include <avr/sleep.h>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+// Interrupt service routines of the program, if it has any
+extern "C" void TIMER0_COMPA_vect() __attribute__((weak));
+extern "C" void PCINT0_vect() __attribute__((weak));
+extern "C" void PCINT1_vect() __attribute__((weak));
+extern "C" void PCINT2_vect() __attribute__((weak));
+extern "C" void TWI_vect() __attribute__((weak));
+
+volatile uint8_t OCR0A;
+volatile uint8_t TIFR0;
+volatile uint8_t TIMSK0;
+volatile uint8_t TWSR;
+volatile uint8_t TWBR;
+TwiControlRegister TWCR;
+volatile uint8_t TWDR;
+volatile uint8_t ADCSRA;
+volatile uint8_t PCICR;
+volatile uint8_t PCIFR;
+volatile uint8_t PCMSK0;
+volatile uint8_t PCMSK1;
+volatile uint8_t PCMSK2;
+
+HardwareSerial Serial;
+const u8g2_cb_t u8g2_cb_r0 {};
+
+namespace {
+// Timer 0 runs with prescaler 64 and overflows every 256 counts (millis() and the compare interrupt)
+constexpr uint64_t TIMER0_PERIOD_US {64ULL * 256 * 1000000 / F_CPU};
+constexpr uint8_t PIN_COUNT {20};
+constexpr uint8_t INTERRUPT_PINS[] {2, 3};   // INT0, INT1
+constexpr uint8_t DISPLAY_ADDRESS {0x3C};     // 7 bit I2C address of the display (0x78 >> 1)
+
+struct PinInterrupt {
+  void (*isr)();
+  int mode;
+  bool pending;
+};
+
+uint64_t virtualTime {0};   // us
+uint64_t nextTimer0 {TIMER0_PERIOD_US};
+std::multimap<uint64_t, std::function<void()>> events;
+bool interruptsEnabled {true};
+uint32_t interruptCount {0};   // Every executed ISR, a sleeping controller wakes up when it changes
+uint8_t sleepMode {SLEEP_MODE_IDLE};
+bool sleeping {false};
+bool halted {false};
+uint32_t sleepCount {0};
+
+bool pinLow[PIN_COUNT];   // All inputs have pullups. Zero initialized, so it is valid for global constructors.
+PinInterrupt pinInterrupts[sizeof(INTERRUPT_PINS)];
+
+std::vector<hal::ToneEvent> toneEvents;
+std::vector<hal::WakeUp> wakeUpEvents;
+hal::Display screen;
+uint64_t screenSince {0};   // Time up to which onTime and contrastTime are summed
+uint32_t loopPasses {0};
+uint32_t framePass {UINT32_MAX};   // Loop pass of the last tile transfer, a transfer in another pass starts a frame
+std::string serialText;
+std::string serialInput;   // Received, not yet read
+uint8_t eepromInverted[E2END + 1];   // Inverted, so the zero initialization is the erased state (0xFF)
+bool serialEcho {true};
+
+// TWI master. The action started by a write to TWCR takes its bit times at the clock of TWBR.
+// The end is counted in ns, so that the 22.5us of a byte at 400kHz do not add up rounded.
+struct Twi {
+  uint64_t doneNs;         // End of the last action
+  bool busOwned;           // Between START and STOP
+  bool addressPhase;       // The next byte is the address
+  bool stopping;
+  hal::TwiStats stats;
+  uint64_t busySince;
+};
+Twi twi {};
+
+// Receiver of the display: the control byte of a transfer selects commands (0x00) or data (0x40).
+// Of the SSD1306 commands only the RAM position, power save and contrast are evaluated.
+struct Panel {
+  bool selected;     // Addressed in the running transfer
+  bool controlByte;  // The next byte is the control byte
+  bool data;
+  uint8_t argument;  // Command that expects an argument (contrast)
+  uint8_t page;
+  uint8_t column;
+};
+Panel panel {};
+
+void callTimer0Compare() {
+  TIFR0 &= ~_BV(OCF0A);
+  ++interruptCount;
+  if (TIMER0_COMPA_vect) { TIMER0_COMPA_vect(); }
+}
+
+// In power down timer 0 is stopped
+void timer0Overflow() {
+  if (sleeping && sleepMode == SLEEP_MODE_PWR_DOWN) { return; }
+  ++interruptCount;   // The millis() interrupt
+  if (TIMSK0 & _BV(OCIE0A)) {
+    TIFR0 |= _BV(OCF0A);
+    if (interruptsEnabled) { callTimer0Compare(); }
+  }
+}
+
+bool twiActive() { return twi.busOwned || twi.stopping || twi.doneNs > virtualTime * 1000; }
+
+void callPinInterrupt(PinInterrupt& pi) {
+  pi.pending = false;
+  ++interruptCount;
+  if (twiActive()) { ++twi.stats.inputsWhileBusy; }
+  pi.isr();
+}
+
+// Pending pin change interrupts (PCIFR) are executed if enabled
+void callPinChangeInterrupts() {
+  void (*const vectors[])() {PCINT0_vect, PCINT1_vect, PCINT2_vect};
+  for (uint8_t group = 0; group < 3; ++group) {
+    if ((PCIFR & _BV(group)) && (PCICR & _BV(group))) {
+      PCIFR &= ~_BV(group);
+      ++interruptCount;
+      if (twiActive()) { ++twi.stats.inputsWhileBusy; }
+      if (vectors[group]) { vectors[group](); }
+    }
+  }
+}
+
+bool triggers(int mode, uint8_t oldLevel, uint8_t level) {
+  switch (mode) {
+    case CHANGE: return oldLevel != level;
+    case FALLING: return oldLevel == HIGH && level == LOW;
+    case RISING: return oldLevel == LOW && level == HIGH;
+    case LOW: return level == LOW;
+    default: return false;
+  }
+}
+
+void accountDisplay() {
+  if (!screen.powerSave) {
+    screen.onTime += virtualTime - screenSince;
+    screen.contrastTime += (virtualTime - screenSince) * screen.contrast;
+  }
+  screenSince = virtualTime;
+}
+
+void setPowerSave(bool enable) {
+  accountDisplay();
+  screen.powerSave = enable;
+  if (!enable && !wakeUpEvents.empty() && !wakeUpEvents.back().displayOn) {
+    wakeUpEvents.back().displayOn = virtualTime;
+  }
+}
+
+void panelReceive(uint8_t byte) {
+  if (panel.controlByte) {
+    panel.controlByte = false;
+    panel.data = (byte & 0x40);
+  } else if (panel.data) {
+    if (panel.page < hal::Display::PAGES && panel.column < hal::Display::WIDTH) {
+      screen.ram[panel.page][panel.column++] = byte;
+    }
+    if (!wakeUpEvents.empty() && !wakeUpEvents.back().firstUpdate) { wakeUpEvents.back().firstUpdate = virtualTime; }
+  } else if (panel.argument == 0x81) {
+    panel.argument = 0;
+    accountDisplay();
+    screen.contrast = byte;
+  } else if (byte <= 0x0F) {
+    panel.column = (panel.column & 0xF0) | byte;
+  } else if (byte <= 0x1F) {
+    panel.column = (panel.column & 0x0F) | ((byte & 0x07) << 4);
+  } else if (byte >= 0xB0 && byte <= 0xB7) {
+    panel.page = byte & 0x07;
+  } else if (byte == 0xAE || byte == 0xAF) {
+    setPowerSave(byte == 0xAE);
+  } else if (byte == 0x81) {
+    panel.argument = byte;
+  }
+}
+
+void callTwi() {
+  ++interruptCount;
+  if (TWI_vect) { TWI_vect(); }
+}
+
+// End of an action: the status is set and TWINT raises the interrupt if enabled
+void twiDone(uint8_t status) {
+  TWSR = status | (TWSR & 0x03);
+  TWCR.value |= _BV(TWINT);
+  if ((TWCR.value & _BV(TWIE)) && interruptsEnabled) { callTwi(); }
+}
+
+// Schedules the end of an action of the given bit times. An action started in the
+// microsecond in which the previous one ended (by the ISR) follows it directly.
+void twiAction(uint8_t bits, std::function<void()> done) {
+  uint64_t start = std::max(virtualTime * 1000, twi.doneNs);
+  if (virtualTime == (twi.doneNs + 999) / 1000) { start = twi.doneNs; }
+  twi.doneNs = start + bits * (1000000000ULL * (16 + 2 * TWBR) / F_CPU);
+  events.emplace((twi.doneNs + 999) / 1000, done);
+}
+
+void twiStart() {
+  if (!twi.busOwned) { twi.busySince = virtualTime; }
+  const uint8_t status = twi.busOwned ? 0x10 : 0x08;   // Repeated START or START
+  twi.busOwned = true;
+  twiAction(1, [=] {
+    twi.addressPhase = true;
+    panel.selected = false;
+    twiDone(status);
+  });
+}
+
+void twiStop() {
+  twi.stopping = true;
+  twiAction(1, [] {
+    TWCR.value &= ~_BV(TWSTO);
+    twi.stopping = false;
+    twi.busOwned = false;
+    panel.selected = false;
+    twi.stats.busyTime += virtualTime - twi.busySince;
+  });
+}
+
+void twiSend(uint8_t byte) {
+  twiAction(9, [=] {   // 8 bits and the acknowledge
+    ++twi.stats.bytes;
+    if (twi.addressPhase) {
+      twi.addressPhase = false;
+      panel.selected = (byte == DISPLAY_ADDRESS << 1);
+      panel.controlByte = true;
+      twiDone(panel.selected ? 0x18 : 0x20);   // Address acknowledged or not
+    } else {
+      if (panel.selected) { panelReceive(byte); }
+      twiDone(panel.selected ? 0x28 : 0x30);
+    }
+  });
+}
+}   // namespace
+
+// Writing a one to TWINT clears it and starts the next action
+TwiControlRegister& TwiControlRegister::operator=(uint8_t newValue) {
+  const bool start = (newValue & _BV(TWINT)) && (newValue & _BV(TWEN));
+  value = start ? (newValue & ~_BV(TWINT)) : (newValue | (value & _BV(TWINT)));
+  if (start) {
+    if (newValue & _BV(TWSTA)) {
+      twiStart();
+    } else if (newValue & _BV(TWSTO)) {
+      twiStop();
+    } else {
+      twiSend(TWDR);
+    }
+  }
+  return *this;
+}
+
+namespace hal {
+
+uint64_t now() { return virtualTime; }
+
+void advance(uint32_t us) {
+  const uint64_t target = virtualTime + us;
+  for (;;) {
+    auto next = events.begin();
+    if (next != events.end() && next->first <= virtualTime) {
+      auto action = next->second;
+      events.erase(next);
+      action();
+      continue;
+    }
+    if (virtualTime >= target) { break; }
+    uint64_t step = target;
+    if (nextTimer0 < step) { step = nextTimer0; }
+    if (next != events.end() && next->first < step) { step = next->first; }
+    virtualTime = step;
+    if (virtualTime == nextTimer0) {
+      nextTimer0 += TIMER0_PERIOD_US;
+      timer0Overflow();
+    }
+  }
+}
+
+bool isHalted() { return halted; }
+uint32_t getSleepCount() { return sleepCount; }
+
+void setPin(uint8_t pin, uint8_t level) {
+  if (pin >= PIN_COUNT) { return; }
+  uint8_t oldLevel = pinLow[pin] ? LOW : HIGH;
+  pinLow[pin] = (level == LOW);
+  for (uint8_t i = 0; i < sizeof(INTERRUPT_PINS); ++i) {
+    PinInterrupt& pi = pinInterrupts[i];
+    if (INTERRUPT_PINS[i] == pin && pi.isr && triggers(pi.mode, oldLevel, level)) {
+      pi.pending = true;
+      if (interruptsEnabled) { callPinInterrupt(pi); }
+    }
+  }
+  if (oldLevel != level && (*digitalPinToPCMSK(pin) & _BV(digitalPinToPCMSKbit(pin)))) {
+    PCIFR |= _BV(digitalPinToPCICRbit(pin));
+    if (interruptsEnabled) { callPinChangeInterrupts(); }
+  }
+}
+
+void schedule(uint64_t at, std::function<void()> action) { events.emplace(at, action); }
+bool hasScheduled() { return !events.empty(); }
+
+void sendSerial(const std::string& text) { serialInput += text; }
+
+const std::vector<ToneEvent>& tones() { return toneEvents; }
+const std::vector<WakeUp>& wakeUps() { return wakeUpEvents; }
+
+const Display& display() {
+  accountDisplay();
+  return screen;
+}
+
+const TwiStats& twi() { return ::twi.stats; }
+void loopPass() { ++loopPasses; }
+
+std::string displayToText() {
+  std::string text;
+  for (uint8_t y = 0; y < screen.height; ++y) {
+    for (uint8_t x = 0; x < Display::WIDTH; ++x) { text += screen.pixel(x, y) ? '#' : '.'; }
+    text += '\n';
+  }
+  return text;
+}
+
+const std::string& serialOutput() { return serialText; }
+void setSerialEcho(bool echo) { serialEcho = echo; }
+
+}   // namespace hal
+
+//
+// Arduino API
+//
+uint32_t millis() { return static_cast<uint32_t>(virtualTime / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(virtualTime); }
+void delay(uint32_t ms) { hal::advance(ms * 1000); }
+void delayMicroseconds(unsigned int us) { hal::advance(us); }
+void yield() { hal::advance(1); }
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t pin) { return (pin < PIN_COUNT && pinLow[pin]) ? LOW : HIGH; }
+
+void attachInterrupt(int8_t interruptNum, void (*isr)(), int mode) {
+  if (interruptNum < 0 || interruptNum >= static_cast<int8_t>(sizeof(INTERRUPT_PINS))) { return; }
+  pinInterrupts[interruptNum] = {isr, mode, false};
+  if (mode == LOW && pinLow[INTERRUPT_PINS[interruptNum]]) { pinInterrupts[interruptNum].pending = true; }
+}
+
+void detachInterrupt(int8_t interruptNum) {
+  if (interruptNum < 0 || interruptNum >= static_cast<int8_t>(sizeof(INTERRUPT_PINS))) { return; }
+  pinInterrupts[interruptNum] = {nullptr, 0, false};
+}
+
+void noInterrupts() { interruptsEnabled = false; }
+
+// Interrupts that occurred in the meantime are executed now
+void interrupts() {
+  interruptsEnabled = true;
+  for (auto& pi : pinInterrupts) {
+    if (pi.pending && pi.isr) { callPinInterrupt(pi); }
+  }
+  callPinChangeInterrupts();
+  if ((TIFR0 & _BV(OCF0A)) && (TIMSK0 & _BV(OCIE0A))) { callTimer0Compare(); }
+  if ((TWCR.value & _BV(TWINT)) && (TWCR.value & _BV(TWIE))) { callTwi(); }
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  toneEvents.push_back({virtualTime, pin, frequency, duration});
+}
+
+void noTone(uint8_t pin) { toneEvents.push_back({virtualTime, pin, 0, 0}); }
+
+uint8_t eeprom_read_byte(const uint8_t* addr) { return ~eepromInverted[reinterpret_cast<uintptr_t>(addr) & E2END]; }
+void eeprom_write_byte(uint8_t* addr, uint8_t value) { eepromInverted[reinterpret_cast<uintptr_t>(addr) & E2END] = ~value; }
+void eeprom_update_byte(uint8_t* addr, uint8_t value) { eeprom_write_byte(addr, value); }
+
+void eeprom_read_block(void* dest, const void* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    static_cast<uint8_t*>(dest)[i] = eeprom_read_byte(static_cast<const uint8_t*>(src) + i);
+  }
+}
+
+void eeprom_update_block(const void* src, void* dest, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    eeprom_update_byte(static_cast<uint8_t*>(dest) + i, static_cast<const uint8_t*>(src)[i]);
+  }
+}
+
+void set_sleep_mode(uint8_t mode) { sleepMode = mode; }
+
+// Advances the time until an interrupt occurs that wakes the controller in the selected sleep mode.
+// If nothing can wake the controller anymore, the simulation is halted: hal::Halt is thrown,
+// because the program would wait in sleep_cpu() forever.
+void sleep_cpu() {
+  ++sleepCount;
+  sleeping = true;
+  const uint32_t count = interruptCount;
+  for (auto& pi : pinInterrupts) {
+    if (pi.pending && pi.isr) { callPinInterrupt(pi); }   // LOW level interrupt
+  }
+  while (count == interruptCount) {
+    uint64_t step;
+    if (sleepMode == SLEEP_MODE_PWR_DOWN) {
+      if (events.empty()) {
+        halted = true;
+        sleeping = false;
+        throw hal::Halt {};
+      }
+      step = events.begin()->first;
+    } else {
+      step = nextTimer0;
+      if (!events.empty() && events.begin()->first < step) { step = events.begin()->first; }
+    }
+    hal::advance((step > virtualTime) ? static_cast<uint32_t>(step - virtualTime) : 0);
+  }
+  sleeping = false;
+  if (sleepMode == SLEEP_MODE_PWR_DOWN) { wakeUpEvents.push_back({virtualTime, 0, 0}); }
+}
+
+int HardwareSerial::available() { return static_cast<int>(serialInput.size()); }
+
+int HardwareSerial::read() {
+  if (serialInput.empty()) { return -1; }
+  int c = static_cast<unsigned char>(serialInput[0]);
+  serialInput.erase(0, 1);
+  return c;
+}
+
+size_t HardwareSerial::print(const char* s) {
+  serialText += s;
+  if (serialEcho) { fputs(s, stdout); }
+  return strlen(s);
+}
+
+size_t HardwareSerial::print(char c) {
+  char s[2] {c, '\0'};
+  return print(s);
+}
+
+size_t HardwareSerial::print(long n) {
+  char s[21];
+  snprintf(s, sizeof(s), "%ld", n);
+  return print(s);
+}
+
+size_t HardwareSerial::print(unsigned long n) {
+  char s[21];
+  snprintf(s, sizeof(s), "%lu", n);
+  return print(s);
+}
+
+//
+// Display
+//
+namespace {
+void setupDisplay(u8g2_t* u8g2, u8x8_msg_cb byteCb, uint8_t tileHeight) {
+  u8g2->u8x8.byteCb = byteCb;
+  u8g2->u8x8.tileWidth = U8G2_TILE_WIDTH;
+  u8g2->u8x8.tileHeight = tileHeight;
+  u8g2->u8x8.i2cAddress = DISPLAY_ADDRESS << 1;
+  screen.height = tileHeight * 8;
+}
+
+void sendTransfer(u8x8_t* u8x8, uint8_t control, const uint8_t* bytes, uint8_t count) {
+  u8x8->byteCb(u8x8, U8X8_MSG_BYTE_START_TRANSFER, 0, nullptr);
+  u8x8->byteCb(u8x8, U8X8_MSG_BYTE_SEND, 1, &control);
+  u8x8->byteCb(u8x8, U8X8_MSG_BYTE_SEND, count, const_cast<uint8_t*>(bytes));
+  u8x8->byteCb(u8x8, U8X8_MSG_BYTE_END_TRANSFER, 0, nullptr);
+}
+
+// Like u8x8_cad_ssd13xx_fast_i2c: the position in one command transfer, the data in transfers of 24 bytes
+void sendTiles(u8x8_t* u8x8, uint8_t x, uint8_t y, uint8_t cnt, const uint8_t* tiles) {
+  const uint8_t column = x * 8;
+  const uint8_t position[] {static_cast<uint8_t>(0x10 | column >> 4), static_cast<uint8_t>(column & 0x0F),
+                            static_cast<uint8_t>(0xB0 | y)};
+  sendTransfer(u8x8, 0x00, position, sizeof(position));
+  for (uint16_t sent = 0; sent < cnt * 8; sent += 24) {
+    sendTransfer(u8x8, 0x40, tiles + sent, static_cast<uint8_t>(std::min(cnt * 8 - sent, 24)));
+  }
+}
+}   // namespace
+
+// The init sequence of U8g2 is reduced to power save and the contrast, the RAM is cleared like by clearDisplay()
+void U8G2::begin() {
+  u8x8_t* u8x8 {getU8x8()};
+  u8x8->byteCb(u8x8, U8X8_MSG_BYTE_INIT, 0, nullptr);
+  const uint8_t init[] {0xAE, 0x81, 0xCF};   // Display off, contrast of the SSD1306 initialisation of U8g2
+  sendTransfer(u8x8, 0x00, init, sizeof(init));
+  const uint8_t empty[U8G2_TILE_WIDTH * 8] {};
+  for (uint8_t y = 0; y < u8x8->tileHeight; ++y) { sendTiles(u8x8, 0, y, U8G2_TILE_WIDTH, empty); }
+  setPowerSave(0);
+}
+
+extern "C" {
+uint8_t u8x8_DrawTile(u8x8_t* u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t* tile_ptr) {
+  if (y >= u8x8->tileHeight || x + cnt > u8x8->tileWidth) { return 0; }
+  screen.tileWrites += cnt;
+  if (loopPasses != framePass) {
+    framePass = loopPasses;
+    ++screen.frames;
+  }
+  sendTiles(u8x8, x, y, cnt, tile_ptr);
+  return 1;
+}
+
+void u8x8_SetPowerSave(u8x8_t* u8x8, uint8_t is_enable) {
+  const uint8_t command {static_cast<uint8_t>(is_enable ? 0xAE : 0xAF)};
+  sendTransfer(u8x8, 0x00, &command, 1);
+}
+
+void u8x8_SetContrast(u8x8_t* u8x8, uint8_t value) {
+  const uint8_t command[] {0x81, value};
+  sendTransfer(u8x8, 0x00, command, sizeof(command));
+}
+
+uint8_t u8x8_gpio_and_delay_arduino(u8x8_t*, uint8_t, uint8_t, void*) { return 1; }
+
+void u8g2_Setup_ssd1306_i2c_128x64_noname_1(u8g2_t* u8g2, const u8g2_cb_t*, u8x8_msg_cb byte_cb, u8x8_msg_cb) {
+  setupDisplay(u8g2, byte_cb, 8);
+}
+
+void u8g2_Setup_ssd1306_i2c_128x32_univision_1(u8g2_t* u8g2, const u8g2_cb_t*, u8x8_msg_cb byte_cb, u8x8_msg_cb) {
+  setupDisplay(u8g2, byte_cb, 4);
+}
+
+void u8g2_Setup_sh1106_i2c_128x64_noname_1(u8g2_t* u8g2, const u8g2_cb_t*, u8x8_msg_cb byte_cb, u8x8_msg_cb) {
+  setupDisplay(u8g2, byte_cb, 8);
+}
+}
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file NativeHal.hpp
+/// \author Kai R. ()
+/// \brief Simulated ATMega328 for running the program on the host (env:native)
+///
+/// The program is compiled unchanged against the Arduino API of this library. The time
+/// is virtual and only advances when the simulation advances it: by loop passes,
+/// delay(), yield() and sleep_cpu(). Inputs are scheduled as pin changes at a virtual
+/// time, outputs (tones, display, Serial) are recorded. The display is an SSD1306 on the
+/// TWI, whose bytes take their time at the I2C clock and raise the TWI interrupt.
+///
+/// \date 2025-06-22
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace hal {
+
+//
+// Virtual clock
+//
+uint64_t now();                 // Microseconds since the start of the simulation
+void advance(uint32_t us);      // Advance the time, timer interrupts and scheduled events are executed
+bool isHalted();                // Power down without any possibility to wake up
+struct Halt {};                 // Thrown by sleep_cpu() when the controller is halted
+uint32_t getSleepCount();
+
+//
+// Inputs
+//
+// The level of an input pin. An attached interrupt is called when the level changes.
+void setPin(uint8_t pin, uint8_t level);
+// Execute an action at a virtual time (in microseconds), e.g. a pin change
+void schedule(uint64_t at, std::function<void()> action);
+bool hasScheduled();
+// Characters received by Serial
+void sendSerial(const std::string& text);
+
+//
+// Outputs
+//
+struct ToneEvent {
+  uint64_t at;            // us
+  uint8_t pin;
+  unsigned int frequency;   // 0 = noTone()
+  unsigned long duration;   // ms, 0 = endless
+};
+const std::vector<ToneEvent>& tones();
+
+// Wake ups from power down
+struct WakeUp {
+  uint64_t at;            // us
+  uint64_t displayOn;     // Time at which the display was switched on again, 0 = not yet
+  uint64_t firstUpdate;   // Time at which the first tile data arrived afterwards, 0 = not yet
+};
+const std::vector<WakeUp>& wakeUps();
+
+struct Display {
+  static constexpr uint8_t WIDTH {128};
+  static constexpr uint8_t PAGES {8};
+  uint8_t ram[PAGES][WIDTH];   // Display RAM, one byte = 8 vertical pixels
+  uint8_t height;
+  bool powerSave;
+  uint8_t contrast;
+  uint32_t tileWrites;         // Tiles (8 bytes) transferred
+  uint32_t frames;             // Display updates: tile transfers within the same loop pass count once
+  uint64_t onTime;             // us switched on (not in power save)
+  uint64_t contrastTime;       // Sum of contrast * us while switched on, / onTime = mean contrast
+  bool pixel(uint8_t x, uint8_t y) const { return ram[y / 8][x] & (1 << (y % 8)); }
+};
+const Display& display();
+std::string displayToText();   // '#' = pixel on
+
+// The display is written through the TWI, which is simulated at the clock set by the program
+struct TwiStats {
+  uint32_t bytes;              // Address and data bytes sent
+  uint64_t busyTime;           // us from START to STOP
+  uint32_t inputsWhileBusy;    // Pin interrupts (encoder, button) executed during a transfer
+};
+const TwiStats& twi();
+
+// Called by the simulation at the start of every loop pass, display updates are counted per pass
+void loopPass();
+
+const std::string& serialOutput();
+void setSerialEcho(bool echo);   // Also print the Serial output to stdout
+
+}   // namespace hal
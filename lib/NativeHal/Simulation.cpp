@@ -0,0 +1,349 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file Simulation.cpp
+/// \author Kai R. ()
+/// \brief Runs setup() and loop() of the program on the host with scripted inputs
+///
+/// Usage: program [--loop-us N] [--quiet] [script]
+///
+/// Script (one command per line, times in ms, # = comment):
+///   wait <ms>          let the time run
+///   turn <steps> [ms]  turn the encoder by steps detents (negative = counterclockwise),
+///                      one detent per ms (default 150 = slow, no acceleration)
+///   press <ms>         press the encoder button for ms
+///   show               print the display
+///   expect <text>      the Serial output since the last expect must contain the text
+///   send <text>        the text is received by Serial, e.g. a command of main.cpp
+///   display <text>     the time cells of the display show the text, e.g. "05:00"
+///                      (' ' = empty cell, '?' = a cell that matches no glyph)
+///   tiles <max>        at most max tiles were transferred since the last tiles check
+///   frames <max>       at most max display updates since the last frames check
+///   overlap <min>      at least min encoder or button interrupts were executed while the
+///                      TWI was sending to the display, since the last overlap check
+///   absent <text>      the Serial output since the last expect does not contain the text
+///   random <count> [seed]  count random inputs: short presses of 30..400ms and turns of
+///                      1..5 detents with 20..200ms per detent, 100..1000ms apart
+///   jitter <us> [seed] from now on each loop pass takes 0..us longer (random), like a
+///                      pass that is delayed by a display transfer
+///   latency <ms>       at the end: every short press got its action (confirmation tone)
+///                      at most ms after the release
+///
+/// The times of the script count from the end of setup().
+/// Without a script a countdown of 3 seconds is set, started and its alarm is switched off.
+/// The exit code is 1 if a check failed. test/scenarios contains the regression scripts.
+///
+/// The display is read with the layout of the default DisplayPolicy of src/main.cpp,
+/// another one has to be passed as build flag (-D DISPLAY_POLICY=...) for both files.
+///
+/// \date 2025-06-22
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "NativeHal.hpp"
+#include "DisplayPolicy.hpp"
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef DISPLAY_POLICY
+  #define DISPLAY_POLICY display::ssd1306x64
+#endif
+
+namespace {
+using Policy = DISPLAY_POLICY;
+
+// Pins of the ATMega328 as in src/main.cpp
+constexpr uint8_t PIN_BTN {4};
+constexpr uint8_t PIN_IN1 {2};
+constexpr uint8_t PIN_IN2 {3};
+
+constexpr uint32_t EDGE_US {1000};     // Time between two encoder edges
+constexpr long DETENT_MS {150};        // Default time per detent of turn
+constexpr uint32_t LOOP_US {20};       // Default run time of a loop pass
+constexpr uint32_t LONG_PRESS_MS {1000};   // as in src/main.cpp
+
+const char DEFAULT_SCRIPT[] {
+    "turn 3\n"
+    "wait 200\n"
+    "press 1500\n"
+    "wait 4000\n"
+    "expect Alarm timer 1\n"
+    "press 100\n"
+    "wait 200\n"
+    "show\n"};
+
+uint64_t cursor {0};   // Time of the next script command
+size_t expectFrom {0};
+int failures {0};
+uint32_t tilesChecked {0};    // tileWrites at the last tiles check
+uint32_t framesChecked {0};   // frames at the last frames check
+uint32_t overlapChecked {0};  // inputsWhileBusy at the last overlap check
+std::mt19937 generator {1};
+uint32_t jitterUs {0};
+long maxLatencyMs {-1};       // -1 = not checked
+std::vector<std::pair<uint64_t, uint64_t>> shortPresses;   // Press and release time
+
+// One detent of the encoder: four edges, the signals are high in the rest position
+void scheduleDetent(bool clockwise, uint32_t us) {
+  const uint8_t first = clockwise ? PIN_IN2 : PIN_IN1;
+  const uint8_t second = clockwise ? PIN_IN1 : PIN_IN2;
+  hal::schedule(cursor, [=] { hal::setPin(first, LOW); });
+  hal::schedule(cursor + EDGE_US, [=] { hal::setPin(second, LOW); });
+  hal::schedule(cursor + 2 * EDGE_US, [=] { hal::setPin(first, HIGH); });
+  hal::schedule(cursor + 3 * EDGE_US, [=] { hal::setPin(second, HIGH); });
+  cursor += (us > 4 * EDGE_US) ? us : 4 * EDGE_US;
+}
+
+void schedulePress(long ms) {
+  hal::schedule(cursor, [] { hal::setPin(PIN_BTN, LOW); });
+  if (ms < LONG_PRESS_MS) { shortPresses.emplace_back(cursor, cursor + ms * 1000); }
+  cursor += ms * 1000;
+  hal::schedule(cursor, [] { hal::setPin(PIN_BTN, HIGH); });
+}
+
+long uniform(long min, long max) { return std::uniform_int_distribution<long> {min, max}(generator); }
+
+void scheduleRandom(long count) {
+  for (long i = 0; i < count; ++i) {
+    cursor += uniform(100, 1000) * 1000;
+    if (uniform(0, 1)) {
+      schedulePress(uniform(30, 400));
+    } else {
+      const long steps {uniform(1, 5)};
+      const bool clockwise {uniform(0, 1) == 1};
+      const long ms {uniform(20, 200)};
+      for (long j = 0; j < steps; ++j) { scheduleDetent(clockwise, ms * 1000); }
+    }
+  }
+}
+
+void expect(const std::string& text, int line) {
+  const std::string& out = hal::serialOutput();
+  size_t pos = out.find(text, expectFrom);
+  if (pos == std::string::npos) {
+    printf("\n[%.3fs] line %d: expected \"%s\" on Serial\n", hal::now() / 1e6, line, text.c_str());
+    ++failures;
+  } else {
+    expectFrom = pos + text.size();
+  }
+}
+
+void absent(const std::string& text, int line) {
+  if (hal::serialOutput().find(text, expectFrom) != std::string::npos) {
+    printf("\n[%.3fs] line %d: unexpected \"%s\" on Serial\n", hal::now() / 1e6, line, text.c_str());
+    ++failures;
+  }
+}
+
+// The time cells read back from the display RAM by the pre-rendered glyphs. The underline and
+// the timer marks (the two top pixel lines) can cross the pages of the digits and are masked out.
+std::string displayedTime() {
+  using Font = Policy::Font;
+  const hal::Display& screen {hal::display()};
+  std::string text;
+  for (uint8_t i = 0; i < Policy::CELLS; ++i) {
+    char found {'?'};
+    for (int g = -1; g < static_cast<int>(sizeof(glyph::CHARACTERS) - 1) && found == '?'; ++g) {   // -1 = empty
+      bool same {true};
+      for (uint8_t p = 0; p < Font::PAGES && same; ++p) {
+        const uint8_t page = Font::FIRST_PAGE + p;
+        uint8_t mask = (page == Policy::LINE_Y / 8) ? ~(1 << (Policy::LINE_Y % 8)) : 0xFF;
+        if (page == 0) { mask &= ~0b11; }
+        for (uint8_t c = 0; c < Policy::cellWidth(i) && same; ++c) {
+          const uint8_t pixels = (g < 0) ? 0 : Font::bitmaps[g][p][c];
+          same = ((screen.ram[page][Policy::cellX(i) + c] ^ pixels) & mask) == 0;
+        }
+      }
+      if (same) { found = (g < 0) ? ' ' : glyph::CHARACTERS[g]; }
+    }
+    text += found;
+  }
+  return text;
+}
+
+void checkDisplay(const std::string& text, int line) {
+  std::string shown {displayedTime()};
+  if (shown != text) {
+    printf("\n[%.3fs] line %d: display shows \"%s\" instead of \"%s\"\n", hal::now() / 1e6, line, shown.c_str(),
+           text.c_str());
+    ++failures;
+  }
+}
+
+// count = the counter now, checked = its value at the last check
+void checkBudget(const char* what, uint32_t count, uint32_t& checked, long max, int line) {
+  if (count - checked > static_cast<uint32_t>(max)) {
+    printf("\n[%.3fs] line %d: %u %s instead of at most %ld\n", hal::now() / 1e6, line, count - checked, what, max);
+    ++failures;
+  }
+  checked = count;
+}
+
+void checkOverlap(long min, int line) {
+  const uint32_t inputs {hal::twi().inputsWhileBusy - overlapChecked};
+  if (inputs < static_cast<uint32_t>(min)) {
+    printf("\n[%.3fs] line %d: %u input interrupts during display transfers instead of at least %ld\n",
+           hal::now() / 1e6, line, inputs, min);
+    ++failures;
+  }
+  overlapChecked = hal::twi().inputsWhileBusy;
+}
+
+// The commands are converted into events at their time
+bool parse(std::istream& script) {
+  std::string text;
+  for (int line = 1; std::getline(script, text); ++line) {
+    std::istringstream in(text);
+    std::string cmd;
+    if (!(in >> cmd) || cmd[0] == '#') { continue; }
+    long value {0};
+    if (cmd == "wait") {
+      in >> value;
+      cursor += value * 1000;
+    } else if (cmd == "turn") {
+      long ms {DETENT_MS};
+      in >> value >> ms;
+      for (long i = 0; i < labs(value); ++i) { scheduleDetent(value > 0, ms * 1000); }
+    } else if (cmd == "press") {
+      in >> value;
+      schedulePress(value);
+    } else if (cmd == "show") {
+      hal::schedule(cursor, [] { printf("\n[%.3fs]\n%s", hal::now() / 1e6, hal::displayToText().c_str()); });
+    } else if (cmd == "send") {
+      std::string text;
+      std::getline(in >> std::ws, text);
+      for (size_t pos; (pos = text.find("\\n")) != std::string::npos;) { text.replace(pos, 2, "\n"); }   // Line end
+      hal::schedule(cursor, [=] { hal::sendSerial(text); });
+    } else if (cmd == "expect") {
+      std::string expected;
+      std::getline(in >> std::ws, expected);
+      hal::schedule(cursor, [=] { expect(expected, line); });
+    } else if (cmd == "absent") {
+      std::string text;
+      std::getline(in >> std::ws, text);
+      hal::schedule(cursor, [=] { absent(text, line); });
+    } else if (cmd == "random") {
+      long seed {0};
+      in >> value;
+      if (in >> seed) { generator.seed(seed); }
+      scheduleRandom(value);
+    } else if (cmd == "jitter") {
+      long seed {0};
+      in >> value;
+      bool seeded {static_cast<bool>(in >> seed)};
+      hal::schedule(cursor, [=] {
+        if (seeded) { generator.seed(seed); }
+        jitterUs = value;
+      });
+    } else if (cmd == "latency") {
+      in >> maxLatencyMs;
+    } else if (cmd == "display") {
+      std::string shown;
+      std::getline(in >> std::ws, shown);
+      hal::schedule(cursor, [=] { checkDisplay(shown, line); });
+    } else if (cmd == "tiles") {
+      in >> value;
+      hal::schedule(cursor, [=] { checkBudget("tiles", hal::display().tileWrites, tilesChecked, value, line); });
+    } else if (cmd == "frames") {
+      in >> value;
+      hal::schedule(cursor, [=] { checkBudget("frames", hal::display().frames, framesChecked, value, line); });
+    } else if (cmd == "overlap") {
+      in >> value;
+      hal::schedule(cursor, [=] { checkOverlap(value, line); });
+    } else {
+      fprintf(stderr, "line %d: unknown command \"%s\"\n", line, cmd.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+}   // namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t loopUs {LOOP_US};
+  const char* file {nullptr};
+  for (int i = 1; i < argc; ++i) {
+    std::string arg {argv[i]};
+    if (arg == "--loop-us" && i + 1 < argc) {
+      loopUs = strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--quiet") {
+      hal::setSerialEcho(false);
+    } else {
+      file = argv[i];
+    }
+  }
+
+  std::ifstream scriptFile;
+  std::istringstream defaultScript {DEFAULT_SCRIPT};
+  std::istream* script {&defaultScript};
+  if (file) {
+    scriptFile.open(file);
+    if (!scriptFile) {
+      fprintf(stderr, "%s: cannot open\n", file);
+      return 2;
+    }
+    script = &scriptFile;
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  uint64_t passes {0};
+  try {
+    setup();
+    cursor = hal::now();   // The script starts when the display has been initialized through the TWI
+    if (!parse(*script)) { return 2; }
+    while (hal::now() < cursor) {
+      hal::loopPass();
+      loop();
+      hal::advance(loopUs + (jitterUs ? uniform(0, jitterUs) : 0));
+      ++passes;
+    }
+  } catch (const hal::Halt&) {
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  printf("\n%llu loop passes, %.3fs simulated, %u sleeps, %zu tones, %u tiles to the display%s\n",
+         static_cast<unsigned long long>(passes), hal::now() / 1e6, hal::getSleepCount(), hal::tones().size(),
+         hal::display().tileWrites, hal::isHalted() ? ", halted in power down" : "");
+  const hal::Display& screen {hal::display()};
+  printf("Display: %u frames, %u bytes, %.3fs on, mean contrast %.0f\n", screen.frames, screen.tileWrites * 8,
+         screen.onTime / 1e6, screen.onTime ? static_cast<double>(screen.contrastTime) / screen.onTime : 0.0);
+  const hal::TwiStats& twi {hal::twi()};
+  printf("TWI: %u bytes, %.3fs busy, %u input interrupts during transfers\n", twi.bytes, twi.busyTime / 1e6,
+         twi.inputsWhileBusy);
+  // Wake to first frame: the display RAM is kept in power save, so the frame is visible when it is switched on
+  uint64_t toFrame {0};
+  uint64_t toUpdate {0};
+  for (const hal::WakeUp& w : hal::wakeUps()) {
+    if (w.displayOn && w.displayOn - w.at > toFrame) { toFrame = w.displayOn - w.at; }
+    if (w.firstUpdate && w.firstUpdate - w.at > toUpdate) { toUpdate = w.firstUpdate - w.at; }
+  }
+  if (!hal::wakeUps().empty()) {
+    printf("Wake ups: %zu, to the first frame max %.3fms, to the first display update max %.3fms\n",
+           hal::wakeUps().size(), toFrame / 1e3, toUpdate / 1e3);
+  }
+  // Press to action: from the release of a short press to its confirmation tone
+  uint64_t toAction {0};
+  size_t actions {0};
+  for (size_t i = 0; i < shortPresses.size(); ++i) {
+    uint64_t until = (i + 1 < shortPresses.size()) ? shortPresses[i + 1].first : UINT64_MAX;
+    for (const hal::ToneEvent& t : hal::tones()) {
+      if (t.frequency && t.at >= shortPresses[i].second && t.at < until) {
+        if (t.at - shortPresses[i].second > toAction) { toAction = t.at - shortPresses[i].second; }
+        ++actions;
+        break;
+      }
+    }
+  }
+  if (actions) { printf("Short presses: %zu with action, release to action max %.3fms\n", actions, toAction / 1e3); }
+  if (maxLatencyMs >= 0 && (actions < shortPresses.size() || toAction > static_cast<uint64_t>(maxLatencyMs) * 1000)) {
+    printf("Latency: %zu of %zu short presses with action, max %.3fms instead of at most %ldms\n", actions,
+           shortPresses.size(), toAction / 1e3, maxLatencyMs);
+    ++failures;
+  }
+  printf("%.3fs host time, %.0f loop passes per second\n", seconds, (seconds > 0) ? passes / seconds : 0.0);
+  return failures ? 1 : 0;
+}
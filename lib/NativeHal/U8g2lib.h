@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file U8g2lib.h
+/// \author Kai R. ()
+/// \brief Display with the U8g2 interface used by the program, for the host-native build.
+///        The commands and tiles are sent through the byte callback like U8g2 does it
+///        for the SSD1306 (u8x8_cad_ssd13xx_fast_i2c), so they pass the TwiPump and the
+///        simulated TWI to the display RAM of the simulation (hal::display()). Only the
+///        commands that the simulation evaluates are sent. The gpio callback is not called.
+///
+/// \date 2025-06-22
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+constexpr uint8_t U8G2_TILE_WIDTH {16};   // 128 pixels
+constexpr uint8_t U8G2_PAGE_BUFFER {U8G2_TILE_WIDTH * 8};
+
+struct u8x8_t;
+typedef uint8_t (*u8x8_msg_cb)(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr);
+
+struct u8x8_t {
+  u8x8_msg_cb byteCb;
+  uint8_t tileWidth;
+  uint8_t tileHeight;
+  uint8_t i2cAddress;
+};
+
+struct u8g2_t {
+  u8x8_t u8x8;
+  uint8_t buffer[U8G2_PAGE_BUFFER];   // One page (_1 mode)
+};
+
+struct u8g2_cb_t {};
+extern const u8g2_cb_t u8g2_cb_r0;
+#define U8G2_R0 (&u8g2_cb_r0)
+
+#define U8X8_PIN_NONE 255
+#define U8X8_PIN_RESET 11
+
+#define U8X8_MSG_BYTE_SEND 23
+#define U8X8_MSG_BYTE_INIT 20
+#define U8X8_MSG_BYTE_SET_DC 32
+#define U8X8_MSG_BYTE_START_TRANSFER 24
+#define U8X8_MSG_BYTE_END_TRANSFER 25
+
+extern "C" {
+uint8_t u8x8_DrawTile(u8x8_t* u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t* tile_ptr);
+void u8x8_SetPowerSave(u8x8_t* u8x8, uint8_t is_enable);
+void u8x8_SetContrast(u8x8_t* u8x8, uint8_t value);
+inline uint8_t u8x8_GetI2CAddress(u8x8_t* u8x8) { return u8x8->i2cAddress; }
+inline void u8x8_SetPin(u8x8_t*, uint8_t, uint8_t) {}
+uint8_t u8x8_gpio_and_delay_arduino(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr);
+
+void u8g2_Setup_ssd1306_i2c_128x64_noname_1(u8g2_t* u8g2, const u8g2_cb_t* rotation, u8x8_msg_cb byte_cb,
+                                             u8x8_msg_cb gpio_and_delay_cb);
+void u8g2_Setup_ssd1306_i2c_128x32_univision_1(u8g2_t* u8g2, const u8g2_cb_t* rotation, u8x8_msg_cb byte_cb,
+                                                u8x8_msg_cb gpio_and_delay_cb);
+void u8g2_Setup_sh1106_i2c_128x64_noname_1(u8g2_t* u8g2, const u8g2_cb_t* rotation, u8x8_msg_cb byte_cb,
+                                            u8x8_msg_cb gpio_and_delay_cb);
+}
+
+class U8G2 {
+public:
+  u8x8_t* getU8x8() { return &u8g2.u8x8; }
+  u8g2_t* getU8g2() { return &u8g2; }
+
+  void begin();   // Initializes the byte callback, clears the display and switches it on
+  void setPowerSave(uint8_t is_enable) { u8x8_SetPowerSave(getU8x8(), is_enable); }
+  void setContrast(uint8_t value) { u8x8_SetContrast(getU8x8(), value); }
+
+  uint8_t getDisplayWidth() const { return u8g2.u8x8.tileWidth * 8; }
+  uint8_t getDisplayHeight() const { return u8g2.u8x8.tileHeight * 8; }
+  uint8_t* getBufferPtr() { return u8g2.buffer; }
+  uint8_t getBufferTileWidth() const { return u8g2.u8x8.tileWidth; }
+
+protected:
+  u8g2_t u8g2 {};
+};
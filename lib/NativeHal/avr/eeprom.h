@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The EEPROM of the ATMega328 (1kB) is simulated by NativeHal. It starts erased (0xFF) with
+// every run and is always ready, a write takes no virtual time.
+#define E2END 0x3FF
+
+inline bool eeprom_is_ready() { return true; }
+uint8_t eeprom_read_byte(const uint8_t* addr);
+void eeprom_write_byte(uint8_t* addr, uint8_t value);
+void eeprom_update_byte(uint8_t* addr, uint8_t value);
+void eeprom_read_block(void* dest, const void* src, size_t n);
+void eeprom_update_block(const void* src, void* dest, size_t n);
@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file io.h
+/// \author Kai R. ()
+/// \brief Registers of the ATMega328 that are used by the program (native build).
+///        They are plain variables, only the timer 0 compare interrupt, the pin
+///        change interrupts and the TWI master are simulated.
+///
+/// \date 2025-06-22
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+extern volatile uint8_t OCR0A;
+extern volatile uint8_t TIFR0;
+extern volatile uint8_t TIMSK0;
+extern volatile uint8_t TWSR;
+extern volatile uint8_t TWBR;
+// A write starts the action of the TWI master like on the controller: START, STOP or
+// sending TWDR. TWINT is set by the simulation when the action is done (NativeHal.cpp).
+struct TwiControlRegister {
+  TwiControlRegister& operator=(uint8_t value);
+  operator uint8_t() const { return value; }
+  volatile uint8_t value;
+};
+extern TwiControlRegister TWCR;
+extern volatile uint8_t TWDR;
+extern volatile uint8_t ADCSRA;
+extern volatile uint8_t PCICR;
+extern volatile uint8_t PCIFR;
+extern volatile uint8_t PCMSK0;   // Pins 8 - 13
+extern volatile uint8_t PCMSK1;   // Pins 14 - 19 (A0 - A5)
+extern volatile uint8_t PCMSK2;   // Pins 0 - 7
+
+// Bits
+constexpr uint8_t OCF0A {1};
+constexpr uint8_t OCIE0A {1};
+constexpr uint8_t TWINT {7};
+constexpr uint8_t TWEA {6};
+constexpr uint8_t TWSTA {5};
+constexpr uint8_t TWSTO {4};
+constexpr uint8_t TWEN {2};
+constexpr uint8_t TWIE {0};
+constexpr uint8_t ADEN {7};
+constexpr uint8_t PCIE0 {0};
+constexpr uint8_t PCIE1 {1};
+constexpr uint8_t PCIE2 {2};
+constexpr uint8_t PCIF0 {0};
+constexpr uint8_t PCIF1 {1};
+constexpr uint8_t PCIF2 {2};
+
+#define _BV(bit) (1 << (bit))
+
+// Interrupt service routines are ordinary functions, which are called by the simulation.
+#define ISR(vector, ...) extern "C" void vector(void)
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// The host has only one address space
+#define PROGMEM
+#define PSTR(s) (s)
+
+inline uint8_t pgm_read_byte(const void* p) { return *static_cast<const uint8_t*>(p); }
+inline uint16_t pgm_read_word(const void* p) {
+  uint16_t w;
+  memcpy(&w, p, sizeof(w));
+  return w;
+}
+inline void* memcpy_P(void* dest, const void* src, size_t n) { return memcpy(dest, src, n); }
@@ -0,0 +1,4 @@
+#pragma once
+
+inline void power_timer1_disable() {}
+inline void power_spi_disable() {}
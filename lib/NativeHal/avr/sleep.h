@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+// The sleep modes are simulated by NativeHal: sleep_cpu() advances the virtual time
+// to the next interrupt that can wake the controller in the selected mode.
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_DOWN 2
+#define SLEEP_MODE_STANDBY 6
+
+void set_sleep_mode(uint8_t mode);
+inline void sleep_enable() {}
+inline void sleep_disable() {}
+void sleep_cpu();
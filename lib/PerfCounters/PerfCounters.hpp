@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file PerfCounters.hpp
+/// \author Kai R. ()
+/// \brief Counters for the time per state and power mode, display frames and wake ups
+///
+/// \date 2025-08-10
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+//
+// The times are measured with micros() at the transitions only (loop pass, sleep, frame),
+// a few additions per loop pass and no allocation. micros() stops in power down (both
+// targets) and in standby on the ATtinys, where the RTC wakes the core once per second.
+// The time in these modes is therefore the difference between the wall clock and the sum
+// of the measured times; the counters give the number of entries.
+//
+namespace perf {
+enum class Power : uint8_t { active = 0, idle, sleep, COUNT };   // sleep = SleepTicker::sleep()
+enum class Wake : uint8_t { button = 0, encoder, second, other, COUNT };
+constexpr uint8_t STATES {3};   // KitchenTimerState off, active, alarm
+
+// Seconds and microseconds, so that the sum does not overflow after 71 minutes like micros()
+struct Duration {
+  uint32_t s {0};
+  uint32_t us {0};
+
+  void add(uint32_t d) {
+    us += d;
+    while (us >= 1000000UL) {
+      us -= 1000000UL;
+      ++s;
+    }
+  }
+
+  template <typename Out> void print(Out& out) const {
+    out.print(s);
+    out.print('.');
+    for (uint32_t digit = 100000UL; digit > 1 && us < digit; digit /= 10) { out.print('0'); }
+    out.print(us);
+  }
+};
+}   // namespace perf
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Performance counters. Called at the transitions by main.cpp, print() dumps them.
+///        PerfCountersOff has the same interface without any code, so the calls need no #ifdef.
+///
+//////////////////////////////////////////////////////////////////////////////
+class PerfCounters {
+public:
+  void begin() { stateMark = powerMark = micros(); }
+
+  // Once per loop pass. state = KitchenTimerState of the displayed timer.
+  void loopPass(uint8_t state) {
+    uint32_t now = micros();
+    stateTime[state].add(now - stateMark);
+    stateMark = now;
+    ++loops;
+  }
+
+  void sleepBegin() { charge(perf::Power::active); }
+  // source determines the cause of the wake up from SleepTicker::sleep(), it is only called if
+  // the counters are active. Idle ends with every interrupt, these wake ups count as other.
+  void sleepEnd(perf::Power mode, perf::Wake (*source)()) {
+    charge(mode);
+    ++wakeups[static_cast<uint8_t>((mode == perf::Power::sleep) ? source() : perf::Wake::other)];
+  }
+
+  // micros() has not counted in power down, the time until the wake up is not charged
+  void powerDownEnd() {
+    stateMark = powerMark = micros();
+    ++powerDowns;
+    ++wakeups[static_cast<uint8_t>(perf::Wake::button)];
+  }
+
+  uint32_t frameBegin() const { return micros(); }
+  void frameEnd(uint32_t start) {
+    uint32_t d = micros() - start;
+    frameTime.add(d);
+    if (d > frameMax) { frameMax = d; }
+    ++frames;
+  }
+
+  void alarm() { ++alarms; }
+  void alarmStopped() { ++alarmsStopped; }
+
+  template <typename Out> void print(Out& out) const;
+
+private:
+  void charge(perf::Power mode) {
+    uint32_t now = micros();
+    powerTime[static_cast<uint8_t>(mode)].add(now - powerMark);
+    powerMark = now;
+  }
+
+  perf::Duration stateTime[perf::STATES];
+  perf::Duration powerTime[static_cast<uint8_t>(perf::Power::COUNT)];
+  perf::Duration frameTime;
+  uint32_t frameMax {0};   // us
+  uint32_t stateMark {0};
+  uint32_t powerMark {0};
+  uint32_t loops {0};
+  uint16_t frames {0};
+  uint16_t wakeups[static_cast<uint8_t>(perf::Wake::COUNT)] {};
+  uint16_t powerDowns {0};
+  uint16_t alarms {0};
+  uint16_t alarmsStopped {0};
+};
+
+// Times in seconds, frameMax in us
+template <typename Out> void PerfCounters::print(Out& out) const {
+  uint32_t ms = millis();
+  perf::Duration uptime;
+  uptime.s = ms / 1000;
+  uptime.us = (ms % 1000) * 1000;
+  out.print(F("PERF uptime "));
+  uptime.print(out);
+  out.print(F(" off "));
+  stateTime[0].print(out);
+  out.print(F(" active "));
+  stateTime[1].print(out);
+  out.print(F(" alarm "));
+  stateTime[2].print(out);
+  out.println();
+  out.print(F("PERF cpu "));
+  powerTime[0].print(out);
+  out.print(F(" idle "));
+  powerTime[1].print(out);
+  out.print(F(" sleep "));
+  powerTime[2].print(out);
+  out.print(F(" powerDown "));
+  out.println(powerDowns);
+  out.print(F("PERF loops "));
+  out.print(loops);
+  out.print(F(" frames "));
+  out.print(frames);
+  out.print(F(" frameTime "));
+  frameTime.print(out);
+  out.print(F(" frameMax "));
+  out.println(frameMax);
+  out.print(F("PERF wake button "));
+  out.print(wakeups[0]);
+  out.print(F(" encoder "));
+  out.print(wakeups[1]);
+  out.print(F(" second "));
+  out.print(wakeups[2]);
+  out.print(F(" other "));
+  out.print(wakeups[3]);
+  out.print(F(" alarms "));
+  out.print(alarms);
+  out.print(F(" stopped "));
+  out.println(alarmsStopped);
+}
+
+class PerfCountersOff {
+public:
+  void begin() {}
+  void loopPass(uint8_t) {}
+  void sleepBegin() {}
+  void sleepEnd(perf::Power, perf::Wake (*)()) {}
+  void powerDownEnd() {}
+  uint32_t frameBegin() const { return 0; }
+  void frameEnd(uint32_t) {}
+  void alarm() {}
+  void alarmStopped() {}
+  template <typename Out> void print(Out&) const {}
+};
@@ -0,0 +1,163 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file PresetStore.hpp
+/// \author Kai R. ()
+/// \brief Wear-leveled store of 16 bit values in the EEPROM
+///
+/// \date 2025-09-07
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+//
+// The EEPROM area is a ring of N records of 5 bytes: sequence number, key, value (2 bytes)
+// and CRC-8. A changed value is not written in place but as a new record into the next
+// slot after the newest record, so the writes are spread over the whole ring. Slots that
+// hold the newest record of a key (live) are skipped. A live record that falls more than
+// AGE_LIMIT writes behind is copied forward before the next write, so all valid records are
+// less than 128 sequence numbers apart and the 8 bit sequence numbers can be compared.
+//
+// begin() reads the ring once and keeps the newest value of each key in the RAM, get() then
+// only reads the RAM. put() changes the RAM and marks the key, writeStep() writes one byte per
+// call when the EEPROM is ready, so nothing waits (about 17ms per record on the ATMega328).
+// A record that is incomplete after a power failure has a wrong CRC and is ignored; the
+// older record of the key is still in another slot. The CRC starts from 0xFF, so an erased
+// (0xFF) or zeroed EEPROM does not contain valid records.
+//
+namespace preset {
+inline uint8_t crc8(uint8_t crc, uint8_t data) {   // Polynomial x^8 + x^2 + x + 1
+  crc ^= data;
+  for (uint8_t i = 0; i < 8; ++i) { crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : crc << 1; }
+  return crc;
+}
+}   // namespace preset
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Store of KEYS values in a ring of N records from the EEPROM address ADDR.
+///        Values that have never been written are 0.
+///
+/// \tparam ADDR  First EEPROM address
+/// \tparam N     Number of records, must be larger than KEYS
+/// \tparam KEYS  Number of values (max. 16)
+//////////////////////////////////////////////////////////////////////////////
+template <uint16_t ADDR, uint8_t N, uint8_t KEYS> class PresetStore {
+public:
+  static constexpr uint8_t RECORD_SIZE {5};
+  static constexpr uint16_t SIZE {N * RECORD_SIZE};   // Bytes of the EEPROM
+  static constexpr uint8_t AGE_LIMIT {64};            // Writes until a live record is copied forward
+  static_assert(KEYS > 0 && KEYS <= 16, "1 to 16 keys are supported");
+  static_assert(N > KEYS, "The ring needs at least one slot that is not live");
+  static_assert(N + AGE_LIMIT < 128, "All valid records must be less than 128 writes apart");
+  static_assert(ADDR + SIZE <= E2END + 1, "The ring does not fit into the EEPROM");
+
+  // Reads the ring, once after the start
+  void begin();
+  uint16_t get(uint8_t key) const { return values[key]; }
+  void put(uint8_t key, uint16_t value) {
+    if (values[key] == value) { return; }
+    values[key] = value;
+    dirty |= 1U << key;
+  }
+  bool isBusy() const { return dirty || writePos < RECORD_SIZE; }
+  // Writes one byte if the EEPROM is ready, to be called from loop()
+  void writeStep();
+
+private:
+  static constexpr uint8_t NONE {0xFF};
+  static constexpr uint8_t CRC_INIT {0xFF};   // From 0 the CRC of a zeroed record would be 0, i.e. valid
+
+  struct Record {
+    uint8_t seq;
+    uint8_t key;
+    uint8_t lo;
+    uint8_t hi;
+    uint8_t crc;
+  };
+
+  static uint8_t* address(uint8_t slot) { return reinterpret_cast<uint8_t*>(ADDR + slot * RECORD_SIZE); }
+  static uint8_t crcOf(const Record& r) {
+    return preset::crc8(preset::crc8(preset::crc8(preset::crc8(CRC_INIT, r.seq), r.key), r.lo), r.hi);
+  }
+  static bool read(uint8_t slot, Record& r) {
+    eeprom_read_block(&r, address(slot), RECORD_SIZE);
+    return r.key < KEYS && r.crc == crcOf(r);
+  }
+  bool isLive(uint8_t slot) const {
+    for (uint8_t key = 0; key < KEYS; ++key) {
+      if (where[key] == slot) { return true; }
+    }
+    return false;
+  }
+  uint8_t nextKey();
+
+  uint16_t values[KEYS] {};
+  uint8_t where[KEYS] {};    // Slot of the newest record of each key, NONE = not written
+  uint8_t seqOf[KEYS] {};    // Its sequence number
+  uint16_t dirty {0};        // One bit per key that has to be written
+  uint8_t seq {0};           // Sequence number of the newest record
+  uint8_t head {N - 1};      // Slot of the newest record
+  uint8_t writePos {RECORD_SIZE};   // Next byte of pending, RECORD_SIZE = no record is written
+  uint8_t writeSlot {0};
+  Record pending {};
+};
+
+template <uint16_t ADDR, uint8_t N, uint8_t KEYS> void PresetStore<ADDR, N, KEYS>::begin() {
+  memset(where, NONE, KEYS);
+  Record r;
+  bool found {false};
+  int8_t newest {0};   // Relative to the sequence number of the first valid record
+  for (uint8_t slot = 0; slot < N; ++slot) {
+    if (!read(slot, r)) { continue; }
+    if (!found) {
+      found = true;
+      seq = r.seq;
+      head = slot;
+    } else if (static_cast<int8_t>(r.seq - seq) > newest) {
+      newest = static_cast<int8_t>(r.seq - seq);
+      head = slot;
+    }
+  }
+  seq += newest;
+  for (uint8_t slot = 0; slot < N; ++slot) {   // The newest record of each key
+    if (!read(slot, r)) { continue; }
+    if (where[r.key] == NONE || static_cast<uint8_t>(seq - r.seq) < static_cast<uint8_t>(seq - seqOf[r.key])) {
+      values[r.key] = r.lo | (r.hi << 8);
+      where[r.key] = slot;
+      seqOf[r.key] = r.seq;
+    }
+  }
+}
+
+// A live record that is too old, otherwise the next changed key
+template <uint16_t ADDR, uint8_t N, uint8_t KEYS> uint8_t PresetStore<ADDR, N, KEYS>::nextKey() {
+  for (uint8_t key = 0; key < KEYS; ++key) {
+    if (where[key] != NONE && static_cast<uint8_t>(seq - seqOf[key]) >= AGE_LIMIT) { return key; }
+  }
+  for (uint8_t key = 0; key < KEYS; ++key) {
+    if (dirty & (1U << key)) { return key; }
+  }
+  return NONE;
+}
+
+template <uint16_t ADDR, uint8_t N, uint8_t KEYS> void PresetStore<ADDR, N, KEYS>::writeStep() {
+  if (writePos >= RECORD_SIZE) {
+    if (!dirty) { return; }
+    uint8_t key {nextKey()};
+    writeSlot = head;
+    do { writeSlot = (writeSlot + 1 < N) ? writeSlot + 1 : 0; } while (isLive(writeSlot));
+    pending = {++seq, key, static_cast<uint8_t>(values[key]), static_cast<uint8_t>(values[key] >> 8), 0};
+    pending.crc = crcOf(pending);
+    dirty &= ~(1U << key);
+    where[key] = writeSlot;
+    seqOf[key] = seq;
+    head = writeSlot;
+    writePos = 0;
+  }
+  if (!eeprom_is_ready()) { return; }
+  eeprom_update_byte(address(writeSlot) + writePos, reinterpret_cast<const uint8_t*>(&pending)[writePos]);
+  ++writePos;
+}
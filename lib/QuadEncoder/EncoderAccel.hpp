@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file EncoderAccel.hpp
+/// \author Kai R. ()
+/// \brief Acceleration of a rotary encoder by the time between the detents
+///
+/// \date 2025-08-31
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Estimates the speed of the encoder from the intervals between the detents and
+///        returns a level for each detent: 1 = slow, 2 = medium, 3 = fast. The intervals
+///        are smoothed (3/4 of the previous average plus 1/4 of the new interval), so a
+///        single quick detent does not accelerate, and it takes about six quick detents
+///        to reach the fastest level. A change of the direction or a pause starts again
+///        with level 1, so the value can be corrected after overshooting.
+///        detent() is meant to be called by the encoder interrupt.
+///
+//////////////////////////////////////////////////////////////////////////////
+class EncoderAccel {
+public:
+  static constexpr uint8_t LEVELS {3};
+  static constexpr uint8_t SLOW_MS {120};     // Longer intervals are level 1 and reset the average
+  static constexpr uint8_t MEDIUM_MS {60};    // Average below: level 2
+  static constexpr uint8_t FAST_MS {25};      // Average below: level 3
+
+  // dir = 1 or -1 of QuadEncoder::tick(), now = millis(). Returns dir * level.
+  int8_t detent(int8_t dir, uint16_t now) {
+    uint16_t interval = now - last;
+    last = now;
+    if (dir != lastDir || interval >= SLOW_MS) {
+      average = SLOW_MS;
+    } else {
+      average = static_cast<uint8_t>((3 * average + interval) / 4);
+    }
+    lastDir = dir;
+    int8_t level = (average < FAST_MS) ? 3 : (average < MEDIUM_MS) ? 2 : 1;
+    return (dir > 0) ? level : -level;
+  }
+
+private:
+  uint16_t last {0};
+  uint8_t average {SLOW_MS};   // ms
+  int8_t lastDir {0};
+};
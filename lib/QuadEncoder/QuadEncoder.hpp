@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file QuadEncoder.hpp
+/// \author Kai R. ()
+/// \brief Decoder for rotary encoders with the pins known at compile time
+///
+/// \date 2025-07-27
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include "FastPin.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Quadrature decoder for encoders with four states per detent, which rest with both
+///        pins high (like RotaryEncoder::LatchMode::FOUR3 of the library by Matthias Hertel,
+///        with the same transition table). The pins are read with FastPin instead of
+///        digitalRead(), tick() is meant to be called by the pin interrupts.
+///
+/// \tparam PIN1  e.g. DT
+/// \tparam PIN2  e.g. CLK
+//////////////////////////////////////////////////////////////////////////////
+template <uint8_t PIN1, uint8_t PIN2> class QuadEncoder {
+public:
+  void begin() {
+    FastPin<PIN1>::inputPullup();
+    FastPin<PIN2>::inputPullup();
+    state = readState();
+  }
+
+  // Returns 1 (clockwise) or -1 (counterclockwise) when a detent has been reached, otherwise 0
+  int8_t tick() {
+    uint8_t now = readState();
+    if (now == state) { return 0; }
+    position += direction(now | (state << 2));
+    state = now;
+    if (now != LATCH) { return 0; }
+    int8_t detents = position >> 2;   // Partial turns are kept, like the library
+    position -= detents * 4;
+    return (detents > 0) ? 1 : (detents < 0) ? -1 : 0;
+  }
+
+private:
+  static constexpr uint8_t LATCH {3};   // Both pins high
+
+  static uint8_t readState() { return (FastPin<PIN1>::read() ? 1 : 0) | (FastPin<PIN2>::read() ? 2 : 0); }
+
+  // Index: new state | old state << 2, 0 = no or invalid transition
+  static int8_t direction(uint8_t transition) {
+    static const int8_t KNOBDIR[] PROGMEM {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+    return static_cast<int8_t>(pgm_read_byte(&KNOBDIR[transition]));
+  }
+
+  uint8_t state {LATCH};
+  int8_t position {0};   // Quarter steps since the last detent
+};
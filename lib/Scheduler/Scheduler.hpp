@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file Scheduler.hpp
+/// \author Kai R. ()
+/// \brief Cooperative scheduler with deadlines and interrupt events
+///
+/// \date 2025-07-06
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Runs tasks from loop() when their time (millis()) has come or when they
+///        have been posted, e.g. by an interrupt. The armed tasks are kept in a list
+///        sorted by their deadline, so the next task and the time until it is due are
+///        known without searching. All memory is allocated statically.
+///        A task runs at most once per arming or posting and may arm itself again.
+///
+/// \tparam N  Number of tasks (max. 8), the tasks are addressed by their index
+//////////////////////////////////////////////////////////////////////////////
+template <uint8_t N> class Scheduler {
+  static_assert(N > 0 && N <= 8, "1 to 8 tasks are supported");
+
+public:
+  using Task = void (*)();
+  using MillisType = decltype(millis());
+  static constexpr MillisType NEVER {static_cast<MillisType>(-1)};
+
+  // A task without a function only serves as a timer (see isArmed()).
+  void add(uint8_t id, Task fn) { tasks[id] = fn; }
+
+  void at(uint8_t id, MillisType time);
+  void after(uint8_t id, MillisType ms) { at(id, millis() + ms); }
+  void cancel(uint8_t id);
+  bool isArmed(uint8_t id) const { return find(id) < armed; }
+
+  // The task runs with the next call of run()
+  void post(uint8_t id) {
+    noInterrupts();
+    posted |= 1 << id;
+    interrupts();
+  }
+  void postFromIsr(uint8_t id) { posted |= 1 << id; }
+
+  // Runs all posted and due tasks, also those that become due in the meantime.
+  // Returns true if a task has run.
+  bool run();
+  // Milliseconds until the next task is due, 0 = now, NEVER = nothing to do.
+  // For a sleep decision the caller must disable the interrupts before the call and keep
+  // them disabled until `interrupts(); sleep_cpu();`, otherwise a task posted by an ISR
+  // after the check is only run after the next wake up.
+  MillisType timeToNext() const;
+
+private:
+  static bool before(MillisType a, MillisType b) { return static_cast<int32_t>(a - b) < 0; }
+  uint8_t find(uint8_t id) const {
+    uint8_t pos = 0;
+    while (pos < armed && order[pos] != id) { ++pos; }
+    return pos;
+  }
+  void call(uint8_t id) {
+    if (tasks[id]) { tasks[id](); }
+  }
+
+  Task tasks[N] {};
+  MillisType deadline[N] {};
+  uint8_t order[N] {};          // Armed tasks, the next due first
+  uint8_t armed {0};
+  volatile uint8_t posted {0};   // One bit per task
+};
+
+template <uint8_t N> void Scheduler<N>::at(uint8_t id, MillisType time) {
+  cancel(id);
+  deadline[id] = time;
+  uint8_t pos = armed++;
+  for (; pos > 0 && before(time, deadline[order[pos - 1]]); --pos) { order[pos] = order[pos - 1]; }
+  order[pos] = id;
+}
+
+template <uint8_t N> void Scheduler<N>::cancel(uint8_t id) {
+  uint8_t pos = find(id);
+  if (pos == armed) { return; }
+  for (--armed; pos < armed; ++pos) { order[pos] = order[pos + 1]; }
+}
+
+template <uint8_t N> bool Scheduler<N>::run() {
+  bool ran {false};
+  for (;;) {
+    noInterrupts();
+    uint8_t events = posted;
+    posted = 0;
+    interrupts();
+    if (events) {
+      for (uint8_t id = 0; id < N; ++id) {
+        if (events & (1 << id)) { call(id); }
+      }
+    } else if (armed && !before(millis(), deadline[order[0]])) {
+      uint8_t id = order[0];
+      cancel(id);
+      call(id);
+    } else {
+      return ran;
+    }
+    ran = true;
+  }
+}
+
+template <uint8_t N> typename Scheduler<N>::MillisType Scheduler<N>::timeToNext() const {
+  if (posted) { return 0; }
+  if (!armed) { return NEVER; }
+  MillisType now = millis();
+  return before(now, deadline[order[0]]) ? deadline[order[0]] - now : 0;
+}
@@ -0,0 +1,17 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file ClockCalibration.cpp
+/// \author Kai R. ()
+/// \brief Counter of the RTC seconds during a calibration
+///
+/// \date 2025-09-14
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "ClockCalibration.hpp"
+
+#ifdef SLEEPTICKER_HAS_RTC
+namespace calibration {
+volatile uint16_t overflows {0};
+}
+#endif
@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file ClockCalibration.hpp
+/// \author Kai R. ()
+/// \brief Measurement of the time base of the countdown against a reference
+///
+/// \date 2025-09-14
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include "SleepTicker.hpp"
+
+//
+// The countdown does not run on the same clock on all controllers: on the ATMega328 it is
+// millis() (crystal or resonator of the main clock), with the RTC it is the internal 32kHz
+// oscillator. The measurement therefore counts in the units of this time base, ms or RTC clocks.
+//
+// start() and stop() are called at two marks of the reference (e.g. two bytes that a host
+// script sends, tools/calibrate.py), result() compares the counted units with the time between
+// the marks according to the reference. The deviation in ppm is positive if the time base runs
+// fast. With 10 minutes between the marks, a mark that is 1ms late is an error of about 2ppm.
+//
+namespace calibration {
+#ifdef SLEEPTICKER_HAS_RTC
+extern volatile uint16_t overflows;   // Seconds of the RTC since start() (ClockCalibration.cpp)
+#endif
+
+// diff * 1000000 / reference as a long division, so that nothing overflows.
+// |diff| must be smaller than reference, reference smaller than 2^31 / 10.
+inline int32_t ppm(int32_t diff, uint32_t reference) {
+  int32_t result {0};
+  for (uint8_t i = 0; i < 6; ++i) {
+    diff *= 10;
+    result = result * 10 + diff / static_cast<int32_t>(reference);
+    diff %= static_cast<int32_t>(reference);
+  }
+  return result;
+}
+}   // namespace calibration
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Measures the deviation of the time base of SleepTicker. With the RTC, the
+///        ticker is started and its hook is replaced while measuring, so no timer may
+///        run at the same time (cancel() before a timer is started).
+///
+//////////////////////////////////////////////////////////////////////////////
+class ClockCalibration {
+public:
+  static constexpr int16_t LIMIT {30000};   // ppm, larger deviations are not plausible
+
+  // First mark of the reference
+  void start(SleepTicker& ticker) {
+#ifdef SLEEPTICKER_HAS_RTC
+    if (!running) {
+      savedHook = SleepTick::hook;
+      savedPeriod = SleepTick::period;
+      savedFraction = SleepTick::fraction;
+    }
+    SleepTick::hook = [] { ++calibration::overflows; };
+    ticker.calibrate(0);   // Raw 32768 clocks per overflow
+    calibration::overflows = 0;
+    ticker.start();
+#else
+    (void)ticker;
+    begin = millis();
+#endif
+    elapsed = 0;
+    running = true;
+  }
+
+  // Second mark of the reference, the units are counted until here
+  void stop(SleepTicker& ticker) {
+    if (!running) { return; }
+#ifdef SLEEPTICKER_HAS_RTC
+    noInterrupts();
+    uint16_t clocks = RTC.CNT;
+    uint16_t seconds = calibration::overflows;
+    if ((RTC.INTFLAGS & RTC_OVF_bm) && clocks < 0x4000) { ++seconds; }   // Overflow not yet handled
+    interrupts();
+    elapsed = static_cast<uint32_t>(seconds) * 32768 + clocks;
+#else
+    elapsed = millis() - begin;
+#endif
+    cancel(ticker);
+  }
+
+  // Ends the measurement without a result
+  void cancel(SleepTicker& ticker) {
+    if (!running) { return; }
+#ifdef SLEEPTICKER_HAS_RTC
+    ticker.stop();
+    SleepTick::hook = savedHook;
+    SleepTick::period = savedPeriod;   // The correction until now
+    SleepTick::fraction = savedFraction;
+#else
+    (void)ticker;
+#endif
+    running = false;
+  }
+
+  bool isRunning() const { return running; }
+
+  // Deviation of the time base in ppm between start() and stop(), referenceMs = the time
+  // between the marks according to the reference. false without a measurement (stop() not
+  // called since start()) or if the deviation is not plausible.
+  bool result(uint32_t referenceMs, int16_t& ppm) const {
+#ifdef SLEEPTICKER_HAS_RTC
+    uint32_t expected = (referenceMs / 125) * 4096 + (referenceMs % 125) * 4096 / 125;   // * 32.768
+#else
+    uint32_t expected = referenceMs;
+#endif
+    if (elapsed == 0 || expected == 0 || expected >= 0x0CCCCCCC) { return false; }   // calibration::ppm() limit
+    int32_t diff = static_cast<int32_t>(elapsed - expected);
+    if (diff >= static_cast<int32_t>(expected) || -diff >= static_cast<int32_t>(expected)) { return false; }
+    int32_t value = calibration::ppm(diff, expected);
+    if (value > LIMIT || value < -LIMIT) { return false; }
+    ppm = static_cast<int16_t>(value);
+    return true;
+  }
+
+private:
+  uint32_t elapsed {0};   // Units of the time base between the marks
+#ifdef SLEEPTICKER_HAS_RTC
+  void (*savedHook)() {nullptr};
+  uint16_t savedPeriod {0};
+  uint8_t savedFraction {0};
+#else
+  uint32_t begin {0};
+#endif
+  bool running {false};
+};
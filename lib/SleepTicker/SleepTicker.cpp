@@ -0,0 +1,32 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file SleepTicker.cpp
+/// \author Kai R. ()
+/// \brief Seconds of the RTC for SleepTicker
+///
+/// \date 2025-06-01
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "SleepTicker.hpp"
+
+namespace SleepTick {
+volatile uint8_t pending {0};
+void (*volatile hook)() {nullptr};
+#ifdef SLEEPTICKER_HAS_RTC
+uint16_t period {32767};
+uint8_t fraction {0};
+uint8_t fractionSum {0};
+#endif
+}
+
+#ifdef SLEEPTICKER_HAS_RTC
+ISR(RTC_CNT_vect) {
+  RTC.INTFLAGS = RTC_OVF_bm;
+  uint8_t sum = SleepTick::fractionSum + SleepTick::fraction;
+  RTC.PER = SleepTick::period + (sum < SleepTick::fraction);   // The counter has just restarted at 0
+  SleepTick::fractionSum = sum;
+  ++SleepTick::pending;
+  if (SleepTick::hook) { SleepTick::hook(); }
+}
+#endif
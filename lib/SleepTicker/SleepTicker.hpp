@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file SleepTicker.hpp
+/// \author Kai R. ()
+/// \brief Sleep between the seconds of an active countdown
+///
+/// \date 2025-06-01
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+  // The RTC runs from the internal 32.768kHz oscillator and keeps counting in standby.
+  // Its overflow wakes the core once per second and is the time base for the countdown.
+  #define SLEEPTICKER_HAS_RTC
+#else
+  #include <avr/power.h>
+// Without a 32kHz crystal neither Timer2 (async) nor the watchdog (+-10%) is precise enough
+// for a countdown. The ATmega328 therefore sleeps in idle mode and keeps the millis() timer running.
+#endif
+
+namespace SleepTick {
+extern volatile uint8_t pending;     // Seconds elapsed since the last call of SleepTicker::consume()
+extern void (*volatile hook)();      // Called by the RTC interrupt every second
+#ifdef SLEEPTICKER_HAS_RTC
+// Length of a second in RTC clocks (SleepTicker::calibrate()): PER + 1 plus fraction / 256
+extern uint16_t period;
+extern uint8_t fraction;
+extern uint8_t fractionSum;   // Sum of the fractions, a carry makes the next second one clock longer
+#endif
+}   // The objects and the RTC interrupt are in SleepTicker.cpp
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Tickless sleep while the countdown is active.
+///        The core sleeps until the next second or a pin interrupt.
+///
+///        Tickless only on the ATtinys (SLEEPTICKER_HAS_RTC): the RTC wakes them from
+///        standby once per second. On the ATMega328, sleep() is the idle mode, from which
+///        the millis() interrupt of Timer0 wakes the core every 1.024ms; only the CPU clock
+///        is stopped in between, the saving of the tickless sleep does not apply there.
+///
+//////////////////////////////////////////////////////////////////////////////
+class SleepTicker {
+public:
+  void begin() {
+#ifdef SLEEPTICKER_HAS_RTC
+    while (RTC.STATUS > 0) {}   // Wait until all RTC registers are synchronized
+    RTC.CLKSEL = RTC_CLKSEL_INT32K_gc;
+    RTC.PER = SleepTick::period;   // 32768 Clocks = 1 Second, see calibrate()
+#else
+    power_timer1_disable();     // Timer0 = millis(), Timer2 = PinTone
+    power_spi_disable();
+#endif
+  }
+
+  // Start the seconds at the time of the call
+  void start() {
+#ifdef SLEEPTICKER_HAS_RTC
+    while (RTC.STATUS > 0) {}
+    RTC.CNT = 0;
+    RTC.PER = SleepTick::period;
+    SleepTick::fractionSum = 0;
+    RTC.INTFLAGS = RTC_OVF_bm;
+    RTC.INTCTRL = RTC_OVF_bm;
+    RTC.CTRLA = RTC_PRESCALER_DIV1_gc | RTC_RUNSTDBY_bm | RTC_RTCEN_bm;
+#endif
+    SleepTick::pending = 0;
+  }
+
+#ifdef SLEEPTICKER_HAS_RTC
+  // Correction of the internal 32kHz oscillator (lib/SleepTicker/ClockCalibration.hpp):
+  // ppm > 0 = the oscillator runs fast, so a second takes more clocks. The length is split into
+  // the period and 1/256 clocks, which the interrupt adds up. Takes effect with the next start().
+  void calibrate(int16_t ppm) {
+    // 32768 * 256 clocks/256 + ppm * 8.388608; 16777 / 2000 = 8.3885 keeps the product in 32 bits
+    uint32_t clocksQ8 = (32768UL << 8) + static_cast<int32_t>(ppm) * 16777 / 2000;
+    SleepTick::period = static_cast<uint16_t>((clocksQ8 >> 8) - 1);
+    SleepTick::fraction = static_cast<uint8_t>(clocksQ8);
+  }
+#endif
+
+  void stop() {
+#ifdef SLEEPTICKER_HAS_RTC
+    while (RTC.STATUS > 0) {}
+    RTC.INTCTRL = 0;
+    RTC.CTRLA = 0;
+#endif
+  }
+
+  // Returns true if a second has elapsed. Only available with the RTC.
+  bool consume() {
+    bool elapsed {false};
+    noInterrupts();
+    if (SleepTick::pending) {
+      --SleepTick::pending;
+      elapsed = true;
+    }
+    interrupts();
+    return elapsed;
+  }
+
+  bool isPending() const { return SleepTick::pending; }
+
+  // Sleep until the next interrupt, at the latest until the next millis() interrupt.
+  // All peripherals keep running. Both idle() and sleep() are called with disabled
+  // interrupts, which are enabled right before sleep_cpu(): an interrupt pending since
+  // the check of the caller then wakes the controller at once.
+  void idle() {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    interrupts();   // The instruction after sei is executed before a pending interrupt
+    sleep_cpu();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  }
+
+  // Sleep until the next interrupt. The sleep mode is restored afterwards.
+  // The serial output must have been flushed before.
+  void sleep() {
+#ifdef SLEEPTICKER_HAS_RTC
+    set_sleep_mode(SLEEP_MODE_STANDBY);
+#else
+    set_sleep_mode(SLEEP_MODE_IDLE);
+#endif
+    interrupts();
+    sleep_cpu();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  }
+};
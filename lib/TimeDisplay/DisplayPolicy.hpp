@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file DisplayPolicy.hpp
+/// \author Kai R. ()
+/// \brief Display controller, geometry and font as compile-time traits
+///
+/// \date 2025-08-24
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "TwiPump.hpp"
+#include "DigitGlyphs.h"   // Generated by tools/glyph_cache.py
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Display controller and its size in pixels
+///
+/// \tparam setup  U8g2 setup function of the controller (page buffer mode)
+/// \tparam W      Pixel columns
+/// \tparam H      Pixel lines
+//////////////////////////////////////////////////////////////////////////////
+template <void (*setup)(u8g2_t*, const u8g2_cb_t*, u8x8_msg_cb, u8x8_msg_cb), uint8_t W, uint8_t H> struct Panel {
+  using Oled = U8G2_TWI_PUMP<setup>;
+  static constexpr uint8_t WIDTH {W};
+  static constexpr uint8_t HEIGHT {H};
+};
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Panel and font of the time "MM:SS". The position of the digits and of the
+///        underline is computed from their traits and checked at compile time, so
+///        TimeDisplay needs no layout at runtime. The cells advance like drawStr() places
+///        the glyphs: by the advance of the digits, the colon by its own advance.
+///
+/// \tparam PANEL  Panel<...>
+/// \tparam FONT   Pre-rendered digits of DigitGlyphs.h, e.g. glyph::Logisoso42
+//////////////////////////////////////////////////////////////////////////////
+template <typename PANEL, typename FONT> struct DisplayPolicy {
+  using Panel = PANEL;
+  using Font = FONT;
+  using Oled = typename PANEL::Oled;
+
+  static constexpr uint8_t CELLS {5};                                             // "MM:SS"
+  static constexpr uint8_t COLON {2};                                             // Cell of ':'
+  static constexpr uint8_t TEXT_WIDTH {FONT::WIDTH * (CELLS - 1) + FONT::COLON_WIDTH};
+  static constexpr uint8_t X {(PANEL::WIDTH - 1 - TEXT_WIDTH) / 2};               // First cell
+  static constexpr uint8_t Y {(PANEL::HEIGHT - 1 + FONT::HEIGHT) / 2};            // Baseline of the digits
+  static constexpr uint8_t LINE_Y {Y + 2};                                        // Underline
+
+  static_assert(PANEL::WIDTH % 8 == 0 && PANEL::HEIGHT % 8 == 0, "The display consists of 8x8 pixel tiles");
+  static_assert(PANEL::WIDTH <= 128, "TimeDisplay marks the tile columns in 16 bits");
+  static_assert(FONT::LINES == PANEL::HEIGHT, "The digits are pre-rendered for another number of display lines");
+  static_assert(TEXT_WIDTH < PANEL::WIDTH, "The time does not fit into the width of the display");
+  static_assert(Y == FONT::BASELINE, "The baseline does not match the pre-rendered digits of tools/glyph_cache.py");
+  static_assert(LINE_Y < PANEL::HEIGHT, "The underline lies below the display");
+
+  // First pixel column and width of a cell
+  static constexpr uint8_t cellX(uint8_t cell) {
+    return X + cell * FONT::WIDTH - ((cell > COLON) ? FONT::WIDTH - FONT::COLON_WIDTH : 0);
+  }
+  static constexpr uint8_t cellWidth(uint8_t cell) { return (cell == COLON) ? FONT::COLON_WIDTH : FONT::WIDTH; }
+};
+
+namespace display {
+using Ssd1306_128x64 = Panel<u8g2_Setup_ssd1306_i2c_128x64_noname_1, 128, 64>;      // 0,96 Inch
+using Sh1106_128x64 = Panel<u8g2_Setup_sh1106_i2c_128x64_noname_1, 128, 64>;        // 1,3 Inch
+using Ssd1306_128x32 = Panel<u8g2_Setup_ssd1306_i2c_128x32_univision_1, 128, 32>;   // 0,91 Inch
+
+using ssd1306x64 = DisplayPolicy<Ssd1306_128x64, glyph::Logisoso42>;
+using sh1106x64 = DisplayPolicy<Sh1106_128x64, glyph::Logisoso42>;
+using ssd1306x32 = DisplayPolicy<Ssd1306_128x32, glyph::Freedoomr25>;
+}   // namespace display
@@ -0,0 +1,38 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file RefreshPolicy.hpp
+/// \author Kai R. ()
+/// \brief How often the display is updated during the countdown
+///
+/// \date 2025-07-13
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief As long as more than coarseAbove seconds remain, only the minutes are displayed
+///        (rounded up, "13:" for 12:01 to 13:00). They are transferred to the display when
+///        the minute changes, and if blinkColon is set, the colon cell every second.
+///        If contrastIdle is not 0, the contrast is reduced to this value when there has
+///        been no input for some time during the countdown, and restored to contrastActive
+///        with the next input or the alarm. contrastActive should be the contrast that
+///        U8g2 sets at begin() (0xCF for the SSD1306 and SH1106), so the display looks
+///        the same as without dimming.
+///
+//////////////////////////////////////////////////////////////////////////////
+struct RefreshPolicy {
+  uint16_t coarseAbove;   // Remaining seconds
+  bool blinkColon;
+  uint8_t contrastActive;
+  uint8_t contrastIdle;   // 0 = no dimming
+};
+
+namespace refresh {
+constexpr RefreshPolicy everySecond {0xFFFF, false, 0, 0};     // Minutes and seconds are always displayed
+constexpr RefreshPolicy minutes {59, false, 0, 0};             // Seconds only in the last minute
+constexpr RefreshPolicy minutesBlink {59, true, 0, 0};         // as minutes, with a blinking colon
+constexpr RefreshPolicy minutesDimmed {59, false, 0xCF, 16};   // as minutes, low contrast without input
+}   // namespace refresh
@@ -0,0 +1,201 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file TimeDisplay.hpp
+/// \author Kai R. ()
+/// \brief Output of the time "MM:SS" with updates of the changed digits only
+///
+/// \date 2025-06-08
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "DisplayPolicy.hpp"
+
+enum class UnderlinePos : uint8_t { none, minutes, seconds };
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Outputs the time on the display. The last output is remembered, and only
+///        the tile columns (8 pixels wide) of the changed cells are transferred to the
+///        display controller. During the countdown this is usually only the last digit.
+///        Of a changed cell only the columns with pixels of the old or the new glyph
+///        are sent, so the narrow colon costs one or two tile columns.
+///        The digits are not drawn with the U8g2 font functions but copied from the
+///        pre-rendered bitmaps in DigitGlyphs.h into the page buffer.
+///        Position, size and font are constants of the policy, so the code is
+///        compiled for exactly one display.
+///
+/// \tparam POLICY  DisplayPolicy<...>, e.g. display::ssd1306x64
+//////////////////////////////////////////////////////////////////////////////
+template <typename POLICY> class TimeDisplay {
+  using OLED = typename POLICY::Oled;
+  using Font = typename POLICY::Font;
+
+public:
+  static constexpr uint8_t CELLS {POLICY::CELLS};
+  static constexpr uint8_t TILE_WIDTH {8};
+  static constexpr uint8_t NO_GLYPH {0xFF};
+  static constexpr uint8_t MARK_WIDTH {8};
+  static constexpr uint8_t MARK_PITCH {10};
+
+  explicit TimeDisplay(OLED& d) : display {d} {}
+
+  void show(uint8_t minutes, uint8_t seconds, UnderlinePos ul);
+  // Only the minutes "MM:" without seconds. If colon is false, the colon cell is empty.
+  void showMinutes(uint8_t minutes, bool colon);
+  // Marks above the digits show which of several timers is displayed (count < 2 = no marks).
+  // The change is output with the next call of show().
+  void setIndicator(uint8_t selected, uint8_t count);
+  // All cells are transferred again with the next call of show(), only the pages of the band
+  void redraw() {
+    memset(cells, 0, CELLS);
+    pendingTiles |= tileMask(0b11111);
+  }
+  // As redraw(), the blank pages are cleared once more
+  void invalidate() {
+    redraw();
+    clearBlank = true;
+  }
+
+  uint16_t getBytesLastUpdate() const { return bytesLastUpdate; }   // Display RAM bytes of the last update
+  uint32_t getBytesTotal() const { return bytesTotal; }
+
+private:
+  static constexpr uint8_t ROWS {POLICY::Panel::HEIGHT / TILE_WIDTH};
+  static_assert(ROWS <= 8, "The band marks the display pages in 8 bits");
+  // Display pages that can contain pixels: the marks in page 0, the digits and the underline.
+  // Only these are composed and sent, the others stay blank since begin().
+  static constexpr uint8_t BAND {static_cast<uint8_t>(1U | (((1U << Font::PAGES) - 1) << Font::FIRST_PAGE) |
+                                                      (1U << (POLICY::LINE_Y / TILE_WIDTH)))};
+
+  // The underline lies below the two digits of the unit
+  static uint8_t underlineCells(UnderlinePos pos) {
+    return (pos == UnderlinePos::minutes) ? 0b00011 : (pos == UnderlinePos::seconds) ? 0b11000 : 0;
+  }
+  static uint8_t glyphIndex(char c) { return (c == ':') ? 10 : (c >= '0' && c <= '9') ? c - '0' : NO_GLYPH; }
+  void update(const char (&text)[CELLS], UnderlinePos ul);
+  static uint16_t tileRange(uint8_t first, uint8_t last) {
+    return static_cast<uint16_t>((2U << (last / TILE_WIDTH)) - (1U << (first / TILE_WIDTH)));
+  }
+  uint16_t tileMask(uint8_t dirtyCells) const;
+  uint16_t inkTiles(uint8_t cell, char c) const;
+  void render(uint16_t tiles);
+
+  OLED& display;
+  char cells[CELLS] {' ', ' ', ' ', ' ', ' '};   // The display is cleared by begin()
+  UnderlinePos underline {UnderlinePos::none};
+  uint8_t indicatorSelected {0};
+  uint8_t indicatorCount {0};
+  uint16_t pendingTiles {0};   // Tiles to be sent with the next update
+  bool clearBlank {false};     // Send the pages outside of BAND with the next update
+  uint16_t bytesLastUpdate {0};
+  uint32_t bytesTotal {0};
+};
+
+template <typename POLICY> void TimeDisplay<POLICY>::show(uint8_t minutes, uint8_t seconds, UnderlinePos ul) {
+  const char text[CELLS] {static_cast<char>('0' + minutes / 10), static_cast<char>('0' + minutes % 10), ':',
+                          static_cast<char>('0' + seconds / 10), static_cast<char>('0' + seconds % 10)};
+  update(text, ul);
+}
+
+template <typename POLICY> void TimeDisplay<POLICY>::showMinutes(uint8_t minutes, bool colon) {
+  const char text[CELLS] {static_cast<char>('0' + minutes / 10), static_cast<char>('0' + minutes % 10),
+                          colon ? ':' : ' ', ' ', ' '};
+  update(text, UnderlinePos::none);
+}
+
+template <typename POLICY> void TimeDisplay<POLICY>::update(const char (&text)[CELLS], UnderlinePos ul) {
+  uint16_t tiles {pendingTiles};
+  for (uint8_t i = 0; i < CELLS; ++i) {
+    if (cells[i] != text[i]) {
+      tiles |= inkTiles(i, cells[i]) | inkTiles(i, text[i]);
+      cells[i] = text[i];
+    }
+  }
+  if (ul != underline) {   // The old and the new underline must be redrawn
+    tiles |= tileMask(underlineCells(underline) | underlineCells(ul));
+    underline = ul;
+  }
+  pendingTiles = 0;
+  bytesLastUpdate = 0;
+  if (tiles) { render(tiles); }
+}
+
+template <typename POLICY> void TimeDisplay<POLICY>::setIndicator(uint8_t selected, uint8_t count) {
+  if (count < 2) { count = 0; }
+  if (selected == indicatorSelected && count == indicatorCount) { return; }
+  uint8_t marks = (count > indicatorCount) ? count : indicatorCount;
+  for (uint8_t x = POLICY::X; x < POLICY::X + marks * MARK_PITCH; x += TILE_WIDTH) {
+    pendingTiles |= 1U << (x / TILE_WIDTH);
+  }
+  pendingTiles |= 1U << ((POLICY::X + marks * MARK_PITCH - 1) / TILE_WIDTH);
+  indicatorSelected = selected;
+  indicatorCount = count;
+}
+
+// Each bit of the result stands for a tile column of the display (128 pixels = 16 tiles)
+template <typename POLICY> uint16_t TimeDisplay<POLICY>::tileMask(uint8_t dirtyCells) const {
+  uint16_t tiles {0};
+  for (uint8_t i = 0; i < CELLS; ++i) {
+    if (dirtyCells & (1 << i)) {
+      uint8_t x = POLICY::cellX(i);
+      tiles |= tileRange(x, x + POLICY::cellWidth(i) - 1);
+    }
+  }
+  return tiles;
+}
+
+// The tile columns with pixels of the glyph c in the cell, 0 for an empty cell
+template <typename POLICY> uint16_t TimeDisplay<POLICY>::inkTiles(uint8_t cell, char c) const {
+  uint8_t idx = glyphIndex(c);
+  if (idx == NO_GLYPH) { return 0; }
+  uint8_t x = POLICY::cellX(cell);
+  return tileRange(x + pgm_read_byte(&Font::ink[idx][0]), x + pgm_read_byte(&Font::ink[idx][1]));
+}
+
+// The page buffer is composed for the tile rows (pages) of the band, only the dirty tile columns
+// are sent. The pages outside of the band are only sent (empty) after invalidate().
+template <typename POLICY> void TimeDisplay<POLICY>::render(uint16_t tiles) {
+  constexpr uint8_t columns {POLICY::Panel::WIDTH / TILE_WIDTH};
+  uint8_t* buffer = display.getBufferPtr();
+  uint8_t band = BAND;
+  if (clearBlank) {
+    band = 0xFF;
+    clearBlank = false;
+  }
+  for (uint8_t row = 0; row < ROWS; ++row) {
+    if (!(band & (1U << row))) { continue; }
+    memset(buffer, 0, POLICY::Panel::WIDTH);
+    if (row >= Font::FIRST_PAGE && row < Font::FIRST_PAGE + Font::PAGES) {
+      for (uint8_t i = 0; i < CELLS; ++i) {
+        uint8_t idx = glyphIndex(cells[i]);
+        if (idx != NO_GLYPH) {
+          memcpy_P(buffer + POLICY::cellX(i), Font::bitmaps[idx][row - Font::FIRST_PAGE], POLICY::cellWidth(i));
+        }
+      }
+    }
+    if (row == 0) {   // The two top pixel lines are above the digits: selected timer = 2 lines, others 1 line
+      for (uint8_t i = 0; i < indicatorCount; ++i) {
+        uint8_t x = POLICY::X + i * MARK_PITCH;
+        for (uint8_t end = x + MARK_WIDTH; x < end; ++x) { buffer[x] |= (i == indicatorSelected) ? 0b11 : 0b10; }
+      }
+    }
+    if (underline != UnderlinePos::none && row == POLICY::LINE_Y / TILE_WIDTH) {
+      uint8_t x = POLICY::cellX((underline == UnderlinePos::minutes) ? 0 : 3);
+      for (uint8_t end = x + Font::WIDTH * 2; x < end; ++x) { buffer[x] |= 1 << (POLICY::LINE_Y % TILE_WIDTH); }
+    }
+    for (uint8_t t = 0; t < columns;) {   // Send each run of dirty tiles with one transfer
+      if (!(tiles & (1U << t))) {
+        ++t;
+        continue;
+      }
+      uint8_t start = t;
+      while (t < columns && (tiles & (1U << t))) { ++t; }
+      u8x8_DrawTile(display.getU8x8(), start, row, t - start, buffer + start * TILE_WIDTH);
+      bytesLastUpdate += (t - start) * TILE_WIDTH;
+    }
+  }
+  bytesTotal += bytesLastUpdate;
+}
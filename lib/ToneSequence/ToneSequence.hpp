@@ -10,6 +10,10 @@
 
 #pragma once
 
+#include <Arduino.h>
+#include "MilliTick.hpp"
+#include "PinTone.hpp"
+
 //
 // Frequencies of the notes
 //
@@ -119,6 +123,62 @@ struct Note {
   const MillisType duration;
 };
 
+// A note is followed by a pause of 30% of its duration (integer arithmetic only)
+inline MillisType playDuration(MillisType duration) { return duration + duration * 3 / 10; }
+
+//
+// Packed notes for melodies in the flash memory (2 bytes instead of 6 per note)
+//
+// Index 0 is a rest, the others are the frequencies of the namespace note
+constexpr unsigned int NOTE_PITCHES[] PROGMEM {
+    0, note::b0, note::c1, note::cs1, note::d1, note::ds1, note::e1, note::f1, note::fs1, note::g1, note::gs1,
+    note::a1, note::as1, note::b1, note::c2, note::cs2, note::d2, note::ds2, note::e2, note::f2, note::fs2,
+    note::g2, note::gs2, note::a2, note::as2, note::b2, note::c3, note::cs3, note::d3, note::ds3, note::e3,
+    note::f3, note::fs3, note::g3, note::gs3, note::a3, note::as3, note::b3, note::c4, note::cs4, note::d4,
+    note::ds4, note::e4, note::f4, note::fs4, note::g4, note::gs4, note::a4, note::as4, note::b4, note::c5,
+    note::cs5, note::d5, note::ds5, note::e5, note::f5, note::fs5, note::g5, note::gs5, note::a5, note::as5,
+    note::b5, note::c6, note::cs6, note::d6, note::ds6, note::e6, note::f6, note::fs6, note::g6, note::gs6,
+    note::a6, note::as6, note::b6, note::c7, note::cs7, note::d7, note::ds7, note::e7, note::f7, note::fs7,
+    note::g7, note::gs7, note::a7, note::as7, note::b7, note::c8, note::cs8, note::d8, note::ds8
+};
+constexpr uint8_t NOTE_COUNT {sizeof(NOTE_PITCHES) / sizeof(NOTE_PITCHES[0])};
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Note with an index into NOTE_PITCHES and a duration code.
+///        Duration code: bit 7 = 0 -> bits 0..6 in 2ms steps (max. 254ms)
+///                       bit 7 = 1 -> bits 0..6 in 16ms steps (max. 2032ms)
+///        Packed notes are created from the Note syntax at compile time:
+///        constexpr PackedNote melody[] PROGMEM {pack({note::f7, 1000 / 4}), ...};
+///
+//////////////////////////////////////////////////////////////////////////////
+struct PackedNote {
+  uint8_t pitch;
+  uint8_t duration;
+};
+
+// Not constexpr, so that an invalid note aborts the compilation of the constexpr melody.
+uint8_t pitchIsNotPartOfNoteTable();
+uint8_t durationIsTooLong();
+
+constexpr uint8_t packPitch(unsigned int pitch, uint8_t idx = 0) {
+  return (idx >= NOTE_COUNT)              ? pitchIsNotPartOfNoteTable()
+         : (NOTE_PITCHES[idx] == pitch) ? idx
+                                          : packPitch(pitch, idx + 1);
+}
+
+constexpr uint8_t packDuration(MillisType ms) {
+  return (ms <= 254) ? (ms + 1) / 2 : (ms <= 2039) ? 0x80 | ((ms + 8) / 16) : durationIsTooLong();
+}
+
+constexpr PackedNote pack(const Note& n) { return {packPitch(n.pitch), packDuration(n.duration)}; }
+
+inline unsigned int unpackPitch(const PackedNote* n) { return pgm_read_word(&NOTE_PITCHES[pgm_read_byte(&n->pitch)]); }
+
+inline MillisType unpackDuration(const PackedNote* n) {
+  uint8_t code = pgm_read_byte(&n->duration);
+  return (code & 0x80) ? (code & 0x7F) * 16UL : code * 2UL;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// \brief Class for non-blocking playback of a sound sequence
 /// 
@@ -135,13 +195,12 @@ public:
           return false;
         }
         timestamp = millis();
-        play_duration = m[idx].duration * 1.30;
-        tone(pin, m[idx].pitch, m[idx].duration);
+        play_duration = playDuration(m[idx].duration);
+        PinTone<pin>::play(m[idx].pitch, m[idx].duration);
         is_tone_on = true;
         [[fallthrough]];
       case true:
         if (millis() - timestamp > play_duration) {
-          // noTone(pin);  necessary?
           ++idx;
           is_tone_on = false;
         }
@@ -166,3 +225,82 @@ private:
   MillisType play_duration;  // max. 65535
   MillisType timestamp;
 };
+
+//
+// Time base for TimedToneSequence, the timer interrupt is shared with other users (MilliTick.hpp)
+//
+namespace ToneTick {
+inline uint16_t fromMillis(MillisType ms) { return MilliTick::fromMillis(ms); }
+inline void enable() { MilliTick::enable(MilliTick::tone); }
+inline void disable() { MilliTick::disable(MilliTick::tone); }
+inline void disableFromIsr() { MilliTick::disableFromIsr(MilliTick::tone); }
+}   // namespace ToneTick
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Class for the playback of a sound sequence from a timer interrupt.
+///        The notes are advanced independently of loop(), so the rhythm is kept
+///        even if loop() is blocked. loop() only starts and stops the sequence.
+///        Only one sequence can be played at a time. The melody must be stored in the
+///        flash memory (PROGMEM) as PackedNote array.
+///
+/// \tparam pin  where the buzzer is connected to.
+//////////////////////////////////////////////////////////////////////////////
+template <byte pin> class TimedToneSequence {
+public:
+  // The sequence is repeated until stop() is called if repeat is true.
+  template <size_t N> void start(const PackedNote (&m)[N], bool repeat = true) {
+    ToneTick::disable();
+    melody = m;
+    count = N;
+    idx = 0;
+    remaining = 0;
+    loop = repeat;
+    playing = true;
+    MilliTick::hooks[MilliTick::tone] = step;
+    ToneTick::enable();
+  }
+
+  void stop() {
+    ToneTick::disable();
+    MilliTick::hooks[MilliTick::tone] = nullptr;
+    PinTone<pin>::stop();
+    playing = false;
+  }
+
+  bool isPlaying() const { return playing; }
+
+private:
+  // Runs in the timer interrupt
+  static void step() {
+    if (remaining) {
+      --remaining;
+      return;
+    }
+    if (idx >= count) {
+      if (!loop) {
+        ToneTick::disableFromIsr();
+        playing = false;
+        return;
+      }
+      idx = 0;
+    }
+    const PackedNote* n = &melody[idx++];
+    MillisType duration = unpackDuration(n);
+    PinTone<pin>::play(unpackPitch(n), duration);   // Pitch 0 (rest) is silent
+    remaining = ToneTick::fromMillis(playDuration(duration));
+  }
+
+  static const PackedNote* melody;   // in PROGMEM
+  static uint8_t count;
+  static uint8_t idx;
+  static uint16_t remaining;   // Timer ticks until the next note
+  static bool loop;
+  static volatile bool playing;
+};
+
+template <byte pin> const PackedNote* TimedToneSequence<pin>::melody {nullptr};
+template <byte pin> uint8_t TimedToneSequence<pin>::count {0};
+template <byte pin> uint8_t TimedToneSequence<pin>::idx {0};
+template <byte pin> uint16_t TimedToneSequence<pin>::remaining {0};
+template <byte pin> bool TimedToneSequence<pin>::loop {false};
+template <byte pin> volatile bool TimedToneSequence<pin>::playing {false};
@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file TraceRing.hpp
+/// \author Kai R. ()
+/// \brief Ring buffer of timestamped events for the analysis of field problems
+///
+/// \date 2025-08-17
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+//
+// A record has 4 bytes: the lower 16 bits of millis(), the event and an argument. When the
+// upper 16 bits of millis() change, a time record with these bits is written first. millis()
+// does not count in power down, so the times are the awake time since the start.
+//
+// print() outputs the records oldest first as hex (tools/trace_decode.py turns them into a
+// timeline):
+//   TRACE START <millis> <count>
+//   TRACE <time:4><event:2><arg:2> ... (8 records per line)
+//   TRACE END
+// mirror() copies the ring into the end of the EEPROM, one byte per call of mirrorStep(),
+// so that it survives a reset. printMirror() outputs the copy in the same format. The ring
+// is not copied into a second buffer (RAM), records added during the copy (about 0.5s on the
+// ATMega328) may replace the oldest ones.
+//
+namespace trace {
+// The numbers are used by tools/trace_decode.py
+enum class Event : uint8_t {
+  time = 0,    // Upper 16 bits of millis() in the time field
+  state,       // Timer state change, arg = slot << 2 | KitchenTimerState
+  step,        // Encoder steps, arg = sum (int8_t) of consecutive steps in one direction
+  button,      // arg = ButtonEvent
+  powerDown,   // Entry of powerDown()
+  wake,        // Exit of powerDown()
+  melody,      // arg = 1 start, 0 stop
+};
+
+struct Record {
+  uint16_t time;
+  Event event;
+  uint8_t arg;
+};
+
+// Hex output with leading zeros
+template <typename Out> void printHex(Out& out, uint16_t value, uint8_t digits) {
+  while (digits) {
+    uint8_t nibble = (value >> (4 * --digits)) & 0x0F;
+    out.print(static_cast<char>((nibble < 10) ? '0' + nibble : 'a' + nibble - 10));
+  }
+}
+
+template <typename Out> void printRecord(Out& out, const Record& r) {
+  printHex(out, r.time, 4);
+  printHex(out, static_cast<uint8_t>(r.event), 2);
+  printHex(out, r.arg, 2);
+}
+}   // namespace trace
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Trace ring with N records. record() may be called in the main program,
+///        the xFromIsr functions in interrupts. TraceRingOff has the same interface
+///        without any code.
+///
+/// \tparam N  Number of records, a power of 2
+//////////////////////////////////////////////////////////////////////////////
+template <uint8_t N> class TraceRing {
+  static_assert(N && !(N & (N - 1)), "N must be a power of 2");
+
+public:
+  static constexpr uint16_t MIRROR_SIZE {2 + N * sizeof(trace::Record)};   // head, count, records
+  static constexpr uint16_t MIRROR_ADDR {E2END + 1 - MIRROR_SIZE};         // End of the EEPROM
+
+  void record(trace::Event e, uint8_t arg = 0) {
+    noInterrupts();
+    recordFromIsr(e, arg);
+    interrupts();
+  }
+
+  void recordFromIsr(trace::Event e, uint8_t arg) {
+    uint32_t ms = millis();
+    uint16_t high = ms >> 16;
+    if (high != timeHigh) {
+      timeHigh = high;
+      put({high, trace::Event::time, 0});
+    }
+    put({static_cast<uint16_t>(ms), e, arg});
+  }
+
+  // Consecutive steps in one direction are summed up in one record
+  void stepFromIsr(int8_t step) {
+    trace::Record& last = ring[(head - 1) & (N - 1)];
+    int8_t sum = static_cast<int8_t>(last.arg);
+    if (count && last.event == trace::Event::step && (sum ^ step) >= 0 && sum != -128 && sum != 127) {
+      last.arg = static_cast<uint8_t>(sum + step);
+      return;
+    }
+    recordFromIsr(trace::Event::step, static_cast<uint8_t>(step));
+  }
+
+  template <typename Out> void print(Out& out) const {
+    out.print(F("TRACE START "));
+    out.print(millis());
+    out.print(' ');
+    out.println(count);
+    for (uint8_t i = 0; i < count; ++i) {
+      noInterrupts();
+      trace::Record r {ring[(head - count + i) & (N - 1)]};
+      interrupts();
+      printLine(out, r, i, count);
+    }
+    out.println(F("TRACE END"));
+  }
+
+  // Start to copy the ring into the EEPROM, e.g. when the alarm sounds
+  void mirror() {
+    noInterrupts();
+    copyHead = head;
+    copyCount = count;
+    interrupts();
+    mirrorPos = 0;
+  }
+
+  // Writes one byte if the EEPROM is ready, so it never waits (about 3.4ms per byte)
+  void mirrorStep() {
+    if (mirrorPos >= MIRROR_SIZE || !eeprom_is_ready()) { return; }
+    uint8_t value = (mirrorPos == 0)   ? copyHead
+                    : (mirrorPos == 1) ? copyCount
+                                       : reinterpret_cast<const uint8_t*>(ring)[mirrorPos - 2];
+    eeprom_update_byte(reinterpret_cast<uint8_t*>(MIRROR_ADDR + mirrorPos), value);
+    ++mirrorPos;
+  }
+
+  template <typename Out> static void printMirror(Out& out) {
+    const uint8_t* addr = reinterpret_cast<const uint8_t*>(MIRROR_ADDR);
+    uint8_t h = eeprom_read_byte(addr);
+    uint8_t n = eeprom_read_byte(addr + 1);
+    if (n > N) { n = 0; }   // Never written (0xFF)
+    out.print(F("TRACE EEPROM "));
+    out.println(n);
+    for (uint8_t i = 0; i < n; ++i) {
+      trace::Record r;
+      eeprom_read_block(&r, addr + 2 + ((h - n + i) & (N - 1)) * sizeof(r), sizeof(r));
+      printLine(out, r, i, n);
+    }
+    out.println(F("TRACE END"));
+  }
+
+private:
+  void put(const trace::Record& r) {
+    ring[head] = r;
+    head = (head + 1) & (N - 1);
+    if (count < N) { ++count; }
+  }
+
+  // Record i of n, 8 records per line
+  template <typename Out> static void printLine(Out& out, const trace::Record& r, uint8_t i, uint8_t n) {
+    if (i % 8 == 0) { out.print(F("TRACE")); }
+    out.print(' ');
+    trace::printRecord(out, r);
+    if (i % 8 == 7 || i + 1 == n) { out.println(); }
+  }
+
+  trace::Record ring[N];
+  uint16_t timeHigh {0};
+  uint16_t mirrorPos {MIRROR_SIZE};
+  uint8_t head {0};
+  uint8_t count {0};
+  uint8_t copyHead {0};    // State of the ring when mirror() was called
+  uint8_t copyCount {0};
+};
+
+class TraceRingOff {
+public:
+  void record(trace::Event, uint8_t = 0) {}
+  void recordFromIsr(trace::Event, uint8_t) {}
+  void stepFromIsr(int8_t) {}
+  template <typename Out> void print(Out&) const {}
+  void mirror() {}
+  void mirrorStep() {}
+  template <typename Out> static void printMirror(Out&) {}
+};
@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file TwiPump.cpp
+/// \author Kai R. ()
+/// \brief TWI interrupt and U8x8 callback of the TwiPump
+///
+/// \date 2025-06-15
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#include "TwiPump.hpp"
+
+TwiPump twiPump;
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+
+void TwiPump::begin() {
+  TWI0.MBAUD = static_cast<uint8_t>(F_CPU / (2 * TWI_CLOCK) - 5);   // Rise time is neglected
+  TWI0.MCTRLA = TWI_WIEN_bm | TWI_ENABLE_bm;
+  TWI0.MSTATUS = TWI_BUSSTATE_IDLE_gc;
+}
+
+// Called with interrupts disabled. The START condition and the address are sent by writing MADDR.
+void TwiPump::startNext() {
+  uint8_t len {0};
+  running = transfers.pop(len);
+  if (running) {
+    remaining = len;
+    TWI0.MADDR = address << 1;
+  } else {
+    TWI0.MCTRLB = TWI_MCMD_STOP_gc;
+  }
+}
+
+void TwiPump::isr() {
+  uint8_t status = TWI0.MSTATUS;
+  if (status & (TWI_ARBLOST_bm | TWI_BUSERR_bm | TWI_RXACK_bm)) {   // The display did not answer
+    ++errors;
+    skipRemaining();
+  }
+  if (remaining) {
+    uint8_t data {0};
+    bytes.pop(data);
+    --remaining;
+    TWI0.MDATA = data;
+  } else {
+    startNext();   // Repeated START for the next transfer or STOP
+  }
+}
+
+ISR(TWI0_TWIM_vect) { twiPump.isr(); }
+
+#else
+
+void TwiPump::begin() {
+  digitalWrite(SDA, HIGH);   // Internal pullups like the Wire library
+  digitalWrite(SCL, HIGH);
+  TWSR = 0;   // Prescaler 1
+  TWBR = static_cast<uint8_t>((F_CPU / TWI_CLOCK - 16) / 2);
+  TWCR = _BV(TWEN);
+}
+
+// Called with interrupts disabled
+void TwiPump::startNext() {
+  uint8_t len {0};
+  running = transfers.pop(len);
+  if (running) {
+    remaining = len;
+    while (TWCR & _BV(TWSTO)) { yield(); }   // A previous STOP must be completed
+    TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN) | _BV(TWIE);
+  } else {
+    TWCR = _BV(TWINT) | _BV(TWSTO) | _BV(TWEN);
+  }
+}
+
+void TwiPump::isr() {
+  switch (TWSR & 0xF8) {
+    case 0x08:   // START sent
+    case 0x10:   // Repeated START sent
+      TWDR = address << 1;
+      TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+      return;
+    case 0x18:   // Address acknowledged
+    case 0x28:   // Data acknowledged
+      break;
+    default:     // NACK, lost arbitration or bus error
+      ++errors;
+      skipRemaining();
+      break;
+  }
+  if (remaining) {
+    uint8_t data {0};
+    bytes.pop(data);
+    --remaining;
+    TWDR = data;
+    TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+  } else {
+    startNext();
+  }
+}
+
+ISR(TWI_vect) { twiPump.isr(); }
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief U8x8 byte callback which passes the transfers to the TwiPump
+///
+//////////////////////////////////////////////////////////////////////////////
+uint8_t u8x8_byte_twi_pump(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr) {
+  switch (msg) {
+    case U8X8_MSG_BYTE_SEND:
+      for (uint8_t* data = static_cast<uint8_t*>(arg_ptr); arg_int > 0; --arg_int) { twiPump.write(*data++); }
+      break;
+    case U8X8_MSG_BYTE_INIT: twiPump.begin(); break;
+    case U8X8_MSG_BYTE_SET_DC: break;
+    case U8X8_MSG_BYTE_START_TRANSFER: twiPump.beginTransmission(u8x8_GetI2CAddress(u8x8) >> 1); break;
+    case U8X8_MSG_BYTE_END_TRANSFER: twiPump.endTransmission(); break;
+    default: return 0;
+  }
+  return 1;
+}
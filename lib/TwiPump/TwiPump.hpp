@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file TwiPump.hpp
+/// \author Kai R. ()
+/// \brief Interrupt driven, non-blocking I2C transfer for U8g2 displays
+///
+/// \date 2025-06-15
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "EventQueue.hpp"
+
+constexpr uint32_t TWI_CLOCK {400000};   // Fast mode
+constexpr uint8_t TWI_QUEUE_SIZE {64};   // Bytes. U8g2 splits the transfers into at most 32 bytes.
+constexpr uint8_t TWI_MAX_TRANSFERS {8};
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief Byte pump for the TWI (ATMega328) or TWI0 (ATtiny) master.
+///        The transfers of U8g2 are queued and sent from the TWI interrupt,
+///        so the CPU only waits if the queue is full. A transfer is started
+///        when it has been queued completely.
+///
+//////////////////////////////////////////////////////////////////////////////
+class TwiPump {
+public:
+  void begin();
+  void beginTransmission(uint8_t a) {
+    address = a;
+    length = 0;
+  }
+  void write(uint8_t data) {
+    // Wait until the ISR has made room. yield() is empty on the controller, in the
+    // simulation (env:native) it lets the time of the TWI pass.
+    while (!bytes.push(data)) { yield(); }
+    ++length;
+  }
+  void endTransmission() {
+    while (!transfers.push(length)) { yield(); }
+    noInterrupts();
+    if (!running) { startNext(); }
+    interrupts();
+  }
+
+  // A frame is in flight as long as queued bytes have not been sent
+  bool isBusy() const { return running || !transfers.isEmpty(); }
+  void flush() {
+    while (isBusy()) { yield(); }
+  }
+  uint16_t getErrors() const { return errors; }
+
+  void isr();   // Only to be called by the TWI interrupt
+
+private:
+  void startNext();
+  void skipRemaining() {
+    uint8_t data {0};
+    while (remaining) {
+      bytes.pop(data);
+      --remaining;
+    }
+  }
+
+  EventQueue<uint8_t, TWI_QUEUE_SIZE> bytes;
+  EventQueue<uint8_t, TWI_MAX_TRANSFERS> transfers;   // Length of every complete transfer in the byte queue
+  uint8_t address {0};                                // 7 bit I2C address
+  uint8_t length {0};                                 // Length of the transfer that is just queued
+  volatile uint8_t remaining {0};                     // Bytes of the running transfer
+  volatile bool running {false};
+  volatile uint16_t errors {0};                       // NACK, lost arbitration or bus errors
+};
+
+extern TwiPump twiPump;   // The TWI interrupt (TwiPump.cpp) serves this instance
+
+// U8x8 byte callback which passes the transfers to the TwiPump
+uint8_t u8x8_byte_twi_pump(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr);
+
+//////////////////////////////////////////////////////////////////////////////
+/// \brief U8g2 display class with the TwiPump as I2C transport
+///
+/// \tparam setup  U8g2 setup function of the display, e.g. u8g2_Setup_ssd1306_i2c_128x64_noname_1
+//////////////////////////////////////////////////////////////////////////////
+template <void (*setup)(u8g2_t*, const u8g2_cb_t*, u8x8_msg_cb, u8x8_msg_cb)> class U8G2_TWI_PUMP : public U8G2 {
+public:
+  U8G2_TWI_PUMP(const u8g2_cb_t* rotation, uint8_t reset = U8X8_PIN_NONE) : U8G2() {
+    setup(&u8g2, rotation, u8x8_byte_twi_pump, u8x8_gpio_and_delay_arduino);
+    u8x8_SetPin(getU8x8(), U8X8_PIN_RESET, reset);
+  }
+};
@@ -0,0 +1,268 @@
+//////////////////////////////////////////////////////////////////////////////
+/// \file Benchmark.hpp
+/// \author Kai R. ()
+/// \brief Cycle measurements of the hot paths of main.cpp (env:bench_nanoatmega328,
+///        env:bench_ATtiny1604)
+///
+/// Is included at the end of main.cpp if KITCHENCLOCK_BENCH is defined. The scenarios
+/// run once instead of loop() and print "BENCH <name> <cycles>" via Serial, checks
+/// print "CHECK <name> <errors>". tools/bench.py runs the program in simavr (ATMega328) or
+/// reads the board via Serial (ATtiny, simavr does not simulate the tinyAVR series) and
+/// writes the results to benchmarks/<env>.json.
+/// No display is connected in simavr, so the I2C transfers end after the address byte.
+/// On the ATtiny, TCB0 counts the cycles instead of sounding the tones, so the melody step
+/// is not measured there.
+///
+/// \date 2025-06-29
+/// \version 1.0
+///
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <avr/wdt.h>
+#include "CycleCounter.hpp"
+#include "MilliTick.hpp"
+
+namespace bench {
+CycleCounter cycles;
+volatile uint32_t wakeStamp {0};
+
+void report(const __FlashStringHelper* name, uint32_t c) {
+  Serial.print(F("BENCH "));
+  Serial.print(name);
+  Serial.print(' ');
+  Serial.println(c);
+  Serial.flush();   // The UART interrupt shall not disturb the next measurement
+}
+
+// Update of one digit during the countdown and output of all cells: full frame (all pages,
+// after invalidate()) and limited to the pages that can contain pixels (redraw())
+void displayUpdate() {
+  KitchenTimer& kT {timers.current()};
+  kT.setMinutes(12);
+  kT.setSeconds(34);
+  kT.setUnitSeconds();
+  timeDisplay.invalidate();
+  twiPump.flush();
+  uint32_t start = cycles.now();
+  displayTime(kT, Underline::no);
+  report(F("displayTime_full"), cycles.since(start));
+
+  twiPump.flush();
+  timeDisplay.redraw();
+  start = cycles.now();
+  displayTime(kT, Underline::no);
+  report(F("displayTime_band"), cycles.since(start));
+
+  twiPump.flush();
+  --kT;
+  start = cycles.now();
+  displayTime(kT, Underline::no);
+  report(F("displayTime_digit"), cycles.since(start));
+  twiPump.flush();
+}
+
+// The U8g2 font from which tools/glyph_cache.py pre-renders the digits of the display
+const uint8_t* font() { return (Display::Panel::HEIGHT == 64) ? u8g2_font_logisoso42_tn : u8g2_font_freedoomr25_mn; }
+
+// Reference for displayTime_full: the same time drawn with the U8g2 font in the firstPage()/
+// nextPage() loop, which composes and sends all pages over the full width
+void pageLoop() {
+  u8g2.setFont(font());
+  twiPump.flush();
+  uint32_t start = cycles.now();
+  u8g2.firstPage();
+  do {
+    u8g2.drawStr(Display::X, Display::Y, "12:33");
+  } while (u8g2.nextPage());
+  report(F("pageLoop_full"), cycles.since(start));
+  twiPump.flush();
+  timeDisplay.invalidate();   // The display content no longer matches the cells
+}
+
+// The pre-rendered cells against the real font: drawStr() draws each digit and the colon at
+// the position of TimeDisplay, every byte of every page must equal the bytes of the tables.
+void glyphCheck() {
+  static const char texts[][Display::CELLS + 1] {"01:23", "45:67", "89:00"};
+  u8g2.setFont(font());
+  uint16_t errors {0};
+  for (const auto& text : texts) {
+    u8g2.firstPage();
+    do {
+      u8g2.drawStr(Display::X, Display::Y, text);
+      const uint8_t row = u8g2.getBufferCurrTileRow();
+      const uint8_t* buffer = u8g2.getBufferPtr();
+      for (uint8_t x = 0; x < Display::Panel::WIDTH; ++x) {
+        uint8_t expected {0};
+        for (uint8_t i = 0; i < Display::CELLS; ++i) {
+          uint8_t column = x - Display::cellX(i);
+          if (column < Display::cellWidth(i) && row >= Display::Font::FIRST_PAGE &&
+              row < Display::Font::FIRST_PAGE + Display::Font::PAGES) {
+            uint8_t idx = (text[i] == ':') ? 10 : text[i] - '0';
+            expected = pgm_read_byte(&Display::Font::bitmaps[idx][row - Display::Font::FIRST_PAGE][column]);
+          }
+        }
+        if (buffer[x] != expected) { ++errors; }
+      }
+    } while (u8g2.nextPage());
+  }
+  Serial.print(F("CHECK glyphs "));
+  Serial.println(errors);
+  twiPump.flush();
+  timeDisplay.invalidate();
+}
+
+// Reference for timer_decrement: the decrement of KitchenTimer before it was packed into
+// 4 bytes (32 bit time, 16 bit multiplier)
+struct UnpackedTimer {
+  uint32_t totalSeconds;
+  size_t multiplier;
+};
+
+__attribute__((noinline)) void decrement(UnpackedTimer& t) {
+  auto save = t.totalSeconds;
+  t.totalSeconds = t.totalSeconds - t.multiplier;
+  if (t.totalSeconds > MAX_TOTALSECONDS) { t.totalSeconds = (t.multiplier == TIMEUNIT_SEC) ? 0 : save % TIMEUNIT_MIN; }
+}
+
+__attribute__((noinline)) void decrement(KitchenTimer& kT) { --kT; }
+
+// One minute of countdown (60 decrements by one second), packed and unpacked
+void timerDecrement() {
+  KitchenTimer kT {1, 0};
+  uint32_t start = cycles.now();
+  for (uint8_t i = 0; i < 60; ++i) { decrement(kT); }
+  report(F("timer_decrement_60"), cycles.since(start));
+
+  UnpackedTimer unpacked {60, TIMEUNIT_SEC};
+  start = cycles.now();
+  for (uint8_t i = 0; i < 60; ++i) { decrement(unpacked); }
+  report(F("timer_decrement_60_unpacked"), cycles.since(start));
+}
+
+// A second elapses while a timer is running (incl. the display update by the scheduler)
+void timerTick() {
+  KitchenTimer& kT {timers.current()};
+  kT.setMinutes(5);
+  ticker.start();
+  timers.start(timers.getCurrent());
+  delay((secondPeriod >> PERIOD_FRACTION_BITS) + 1);
+  twiPump.flush();
+  uint32_t start = cycles.now();
+  runTimers();
+  scheduler.run();
+  report(F("runTimers_tick"), cycles.since(start));
+  twiPump.flush();
+  timers.stop(timers.getCurrent());
+  ticker.stop();
+}
+
+// One encoder step is evaluated and displayed by the scheduler
+void encoderStep() {
+  KitchenTimer& kT {timers.current()};
+  setDisplayForInput(kT, input);
+  processInput(kT, input);   // Unit change
+  scheduler.run();
+  twiPump.flush();
+  input.steps.push(1);
+  uint32_t start = cycles.now();
+  processInput(kT, input);
+  scheduler.run();
+  report(F("processInput_step"), cycles.since(start));
+  twiPump.flush();
+}
+
+// The timer interrupt advances the melody to the next note
+void noteAdvance() {
+  signal.start(melody);
+  ToneTick::disable();   // The step is called here instead of the ISR
+  uint32_t start = cycles.now();
+  MilliTick::hooks[MilliTick::tone]();
+  report(F("toneSequence_note"), cycles.since(start));
+  signal.stop();
+}
+
+// Drives the button pin low, which triggers the pin change interrupt, and starts the time
+void press() {
+  wakeStamp = cycles.now();
+  FastPin<PIN_BTN>::low();
+  FastPin<PIN_BTN>::output();
+}
+
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+volatile uint8_t wakeTicks {0};
+
+// MilliTick hook of the tone user: the RTC periodic interrupt also runs in power down
+void pressAfterTicks() {
+  if (--wakeTicks) { return; }
+  MilliTick::disableFromIsr(MilliTick::tone);
+  press();
+}
+#endif
+
+// From the wake up interrupt until powerDown() returns and until the command that switches
+// the display on has been transferred (first frame, the display RAM is kept).
+// A timer interrupt presses the button after about 16ms: the watchdog on the ATMega328, the
+// RTC periodic interrupt (MilliTick) on the ATtiny. The time includes the debouncing of the press.
+void wakeFromPowerDown() {
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+  wakeTicks = 16;
+  MilliTick::hooks[MilliTick::tone] = pressAfterTicks;   // Free, the melody is stopped
+  MilliTick::enable(MilliTick::tone);
+#else
+  cli();
+  wdt_reset();
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = _BV(WDIE);   // Interrupt after 16ms
+  sei();
+#endif
+  powerDown();
+  uint32_t wake = cycles.since(wakeStamp);
+  twiPump.flush();
+  uint32_t frame = cycles.since(wakeStamp);
+  FastPin<PIN_BTN>::inputPullup();   // Release
+  while (btn.isActive()) {}
+  report(F("powerDown_wake"), wake);
+  report(F("wake_first_frame"), frame);
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+  MilliTick::hooks[MilliTick::tone] = nullptr;
+#endif
+}
+
+void run() {
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+  while (Serial.read() < 0) {}   // tools/bench.py starts the run by sending a line end
+#endif
+  cycles.begin();
+  Serial.println(F("BENCH START"));
+  Serial.flush();
+  displayUpdate();
+  pageLoop();
+  glyphCheck();
+  timerTick();
+  timerDecrement();
+  encoderStep();
+#if !defined(__AVR_ATtiny1604__) && !defined(__AVR_ATtiny1614__)
+  noteAdvance();   // The tone would take TCB0 from the cycle counter
+#endif
+  wakeFromPowerDown();
+  Serial.println(F("BENCH END"));
+  Serial.flush();
+  cli();
+  sleep_cpu();   // simavr ends the simulation if the controller sleeps with interrupts disabled
+}
+}   // namespace bench
+
+#if !defined(__AVR_ATtiny1604__) && !defined(__AVR_ATtiny1614__)
+ISR(WDT_vect) {
+  wdt_disable();
+  bench::press();
+}
+#endif
+
+// Called by the Arduino core before setup()
+void initVariant() {
+  setup();
+  bench::run();
+}
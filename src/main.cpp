@@ -9,52 +9,89 @@
 /// @copyright Copyright (c) 2023
 ///
 //////////////////////////////////////////////////////////////////////////////
+// Display, see lib/TimeDisplay/DisplayPolicy.hpp (default: 0,96" SSD1306 with 64 pixel lines)
+// #define DISPLAY_POLICY display::sh1106x64    // 1,3" SH1106
+// #define DISPLAY_POLICY display::ssd1306x32   // 0,91" SSD1306 with 32 pixel lines
+
+// #define MINUTES_DEFAULT   // Remove the comment if you want the time setting to start with the minutes.
+
+// #define DISPLAY_STATS     // Remove the comment to output the bytes sent to the display per update via Serial
+// #define MEMORY_STATS      // Remove the comment to output the RAM usage via Serial at the start and on 'm'
+// #define PERF_STATS        // Remove the comment to count the time per state and power mode, output on 'p' via Serial
+// #define TRACE             // Remove the comment to record the last events, output on 't' via Serial
+// #define TRACE_EEPROM      // Additionally copy the trace into the EEPROM when an alarm sounds, output on 'e'
+// #define CALIBRATION       // Remove the comment to measure the clock against a PC via Serial (tools/calibrate.py)
+
+// Display updates during the countdown, see lib/TimeDisplay/RefreshPolicy.hpp
+// #define REFRESH_POLICY refresh::minutesBlink
+
 #include <avr/sleep.h>
 #include <Arduino.h>
 #include <U8g2lib.h>
-#include <RotaryEncoder.h>
-#include "Button_SL.hpp"
+#include "IrqButton.hpp"
+#include "QuadEncoder.hpp"
+#include "EncoderAccel.hpp"
 #include "KitchenTimer.hpp"
+#include "KitchenTimerPool.hpp"
 #include "ToneSequence.hpp"
-
-// #define SH1106            // Remove the comment if the display has 1,3"
-// #define DISPLAY_Y32       // Remove the comment if the display has only 32 instead of 64 pixel lines
-
-// #define MINUTES_DEFAULT   // Remove the comment if you want the time setting to start with the minutes.
+#include "PinTone.hpp"
+#include "SleepTicker.hpp"
+#include "ClockCalibration.hpp"
+#include "EventQueue.hpp"
+#include "TimeDisplay.hpp"
+#include "DisplayPolicy.hpp"
+#include "RefreshPolicy.hpp"
+#include "TwiPump.hpp"
+#include "Scheduler.hpp"
+#include "MemoryMonitor.hpp"
+#include "PerfCounters.hpp"
+#include "TraceRing.hpp"
+#include "PresetStore.hpp"
 
 //
 // gobal constants
 //
 
 // If the time is running ahead or behind, the inaccuracy of the oscillator can be compensated
-// somewhat via this "SECOND" value.
-constexpr uint16_t SECOND {997};      // 1000ms = 1 Second
+// somewhat via this "SECOND" value. The second parameter adds 1/256 ms steps to the period.
+// It is used until the clock has been calibrated (CALIBRATION), then secondPeriod is computed
+// from the measured deviation.
+constexpr uint32_t SECOND {periodQ8(997, 0)};   // 1000ms = 1 Second
 constexpr uint16_t TIMEOUT {10000};
-
-constexpr uint8_t BUFFERLENGTH {6};   // 5 characters + end-of-string character '\0'.
-constexpr uint8_t DISPLAY_MAX_X {127};
-
-#ifndef DISPLAY_Y32
-// u8g2_font_logisoso42_tn   // 24 Width 51 Height
-constexpr uint8_t DISPLAY_MAX_Y {63};
-constexpr uint8_t FONT_WIDTH {24};
-constexpr uint8_t FONT_HIGHT {51};
-#else
-// Font u8g2_font_inb21mn          // 18 Width 27 High      Another option
-// Font u8g2_font_logisoso20_tn    // 13 Width 26 High      Another option
-// Font u8g2_font_freedoomr25_mn   // 19 Width 26 Height
-constexpr uint8_t DISPLAY_MAX_Y {31};
-constexpr uint8_t FONT_WIDTH {19};
-constexpr uint8_t FONT_HIGHT {26};
+constexpr uint16_t LONG_PRESS {1000};     // ms
+#ifndef REFRESH_POLICY
+  #define REFRESH_POLICY refresh::everySecond
 #endif
-
-// The following display values are calculated from the upper four values. No change necessary.
-constexpr uint8_t DISPLAY_X {(DISPLAY_MAX_X - FONT_WIDTH * (BUFFERLENGTH - 1)) / 2};   // Column = X Coordinate
-constexpr uint8_t DISPLAY_Y {(DISPLAY_MAX_Y + FONT_HIGHT) / 2};                        // Row = Y coordinate
-constexpr uint8_t MINUTES_LINE_X {DISPLAY_X};    // LINE = Coordinates for the line under minute and second digits
-constexpr uint8_t SECONDS_LINE_X {DISPLAY_X + FONT_WIDTH * 3};
-constexpr uint8_t LINE_Y {DISPLAY_Y + 2};        // Line below the numbers
-constexpr uint8_t LINE_WIDTH {FONT_WIDTH * 2};   // Line length = font width * 2
+constexpr RefreshPolicy REFRESH {REFRESH_POLICY};
+constexpr uint8_t DIM_DELAY {TIMEOUT / 1000};   // Countdown seconds without input, then the display is dimmed
+
+constexpr uint8_t TIMER_COUNT {4};           // Independent timers, with 1 there is no timer selection
+constexpr uint8_t ENCODER_QUEUE_SIZE {16};   // Encoder steps that can be buffered between two loop passes
+constexpr uint8_t FRAME_INTERVAL {40};       // ms, while the encoder is turned the display is updated at most this often
+// Change of the time per detent depending on the speed of the encoder (EncoderAccel level 1 - 3)
+constexpr uint8_t ACCEL_SECONDS[EncoderAccel::LEVELS] {1, 5, 15};   // Seconds
+constexpr uint8_t ACCEL_MINUTES[EncoderAccel::LEVELS] {1, 5, 5};    // Minutes
+constexpr uint8_t TRACE_SIZE {32};       // Records (4 bytes) of the trace ring
+constexpr uint8_t PRESET_COUNT {4};      // Started times that can be recalled, most recent first
+constexpr uint8_t PRESET_RECORDS {24};   // Records (5 bytes) of the preset store at the start of the EEPROM
+
+// Tasks of the scheduler
+namespace task {
+constexpr uint8_t countdown {0};   // The next second of the running timers
+constexpr uint8_t refresh {1};     // Output of the displayed timer
+constexpr uint8_t timeout {2};     // No input for TIMEOUT ms
+constexpr uint8_t button {3};      // Events of the button driver
+constexpr uint8_t dim {4};         // Reduce the contrast (REFRESH.contrastIdle)
+constexpr uint8_t count {5};
+}   // namespace task
+
+// Keys of the preset store
+namespace key {
+constexpr uint8_t lastUsed {0};             // + timer slot: the time of its last start
+constexpr uint8_t preset {TIMER_COUNT};     // + 0 .. PRESET_COUNT - 1: the started times, most recent first
+constexpr uint8_t calibration {TIMER_COUNT + PRESET_COUNT};   // int16_t ppm of the time base, 0 = not calibrated
+constexpr uint8_t count {TIMER_COUNT + PRESET_COUNT + 1};
+}   // namespace key
 
 #if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
 constexpr uint8_t PIN_BTN {0};                   // SW on rotary encoder
@@ -71,28 +108,19 @@ constexpr uint8_t PIN_IN2 {3};      // CLK  ---- " ----
 constexpr uint8_t PIN_ALARM {13};   // Buzzer
 #endif
 
-//////////////////////////////////////////////////////////////////////////////
-/// \brief Helperclass for a non blocking delay
-///
-//////////////////////////////////////////////////////////////////////////////
-class NbDelay {
-  using MillisType = decltype(millis());
-
-public:
-  void start() { timestamp = millis(); }
-  boolean operator()(const MillisType duration) { return millis() - timestamp >= duration; }
-
-private:
-  MillisType timestamp {0};
-};
-
 //
 // Global objects / variables
 //
 
+// Encoder steps decoded in the pin interrupt: +1 / -1 times the EncoderAccel level
+using EncoderQueue = EventQueue<int8_t, ENCODER_QUEUE_SIZE>;
+
 struct InputState {
   enum class state : uint8_t { seconds = 0, minutes };
-  RotaryEncoder encoder {PIN_IN1, PIN_IN2, RotaryEncoder::LatchMode::FOUR3};
+  static constexpr uint8_t NO_PRESET {0xFF};
+  QuadEncoder<PIN_IN1, PIN_IN2> encoder;
+  EncoderAccel accel;
+  EncoderQueue steps;
 #ifndef MINUTES_DEFAULT
   const state defaultState {state::seconds};
   state lastState {state::minutes};
@@ -101,53 +129,95 @@ struct InputState {
   state lastState {state::seconds};
 #endif
   state currentState {defaultState};
+  uint8_t preset {NO_PRESET};   // Recalled time (nextPreset()) that has not been changed yet
 } input;
 
 // initialize OLED
-// Controller: SH1106 or SSD1306
-// Page buffer mode is used
-#ifdef SH1106
-using OLED_DP = U8G2_SH1106_128X64_NONAME_1_HW_I2C;   // 1,3 Inch SH1106
-#else
-  #ifndef DISPLAY_Y32
-using OLED_DP = U8G2_SSD1306_128X64_NONAME_1_HW_I2C;   // 0,96 Inch SSD1306
-  #else
-using OLED_DP = U8G2_SSD1306_128X32_UNIVISION_1_HW_I2C;   // 0,91 Inch SSD1306
-  #endif
+// Page buffer mode is used, the I2C transfer runs in the background (TwiPump.hpp)
+#ifndef DISPLAY_POLICY
+  #define DISPLAY_POLICY display::ssd1306x64
 #endif
+using Display = DISPLAY_POLICY;
+using OLED_DP = Display::Oled;
 
 OLED_DP u8g2(U8G2_R0, /* reset=*/U8X8_PIN_NONE);
+TimeDisplay<Display> timeDisplay {u8g2};
+uint32_t frameStamp {0};   // millis() of the last output by displayTime()
 
 enum class Underline : byte { no, yes };
 
-using namespace Btn;
-ButtonSL btn {PIN_BTN};
-NbDelay wait;   // This class is defined in AlarmTone.hpp
-KitchenTimer ktTimer;
+IrqButton<PIN_BTN> btn {LONG_PRESS};
+Scheduler<task::count> scheduler;
+KitchenTimerPool<TIMER_COUNT> timers;
+SleepTicker ticker;
+ClockCalibration clockCalibration;
+uint32_t secondPeriod {SECOND};   // Q8 ms of a second on millis(), see applyCalibration()
+uint8_t idleSeconds {0};          // Countdown seconds since the last input, up to DIM_DELAY
+#ifdef PERF_STATS
+PerfCounters counters;
+#else
+PerfCountersOff counters;   // The calls compile to nothing
+#endif
+#ifdef TRACE
+TraceRing<TRACE_SIZE> traceRing;
+#else
+TraceRingOff traceRing;
+#endif
+PresetStore<0, PRESET_RECORDS, key::count> presets;
+#ifdef TRACE_EEPROM
+static_assert(decltype(presets)::SIZE <= TraceRing<TRACE_SIZE>::MIRROR_ADDR,
+              "The preset store and the copy of the trace overlap in the EEPROM");
+#endif
 
 // note f7 has 2794Hz is good for buzzer with 2700Hz resonance frequency
-constexpr Note melody[] {
-    {note::f7, 1000 / 4 },
-    {0,        1000 / 20},
-    {note::f7, 1000 / 8 },
-    {0,        1000 / 20},
-    {note::f7, 1000 / 4 },
-    {0,        2000     },
+// The notes are packed at compile time and stay in the flash memory.
+constexpr PackedNote melody[] PROGMEM {
+    pack({note::f7, 1000 / 4}),
+    pack({0,        1000 / 20}),
+    pack({note::f7, 1000 / 8}),
+    pack({0,        1000 / 20}),
+    pack({note::f7, 1000 / 4}),
+    pack({0,        2000}),
 };
 // AlarmTone alarm {PIN_ALARM};
-ToneSequence<PIN_ALARM> signal;
+TimedToneSequence<PIN_ALARM> signal;   // The notes are advanced by a timer interrupt
+using Buzzer = PinTone<PIN_ALARM>;     // Confirmation tones
 
 //
 // Forward declaration function(s).
 //
-void intWakeup();
-void powerDown(uint8_t wakeupPin);
-KitchenTimerState runTimer(KitchenTimer&);
-bool askEncoder(RotaryEncoder&, KitchenTimer&);
+void intButton();
+void attachButton(uint8_t pin);
+void intEncoder();
+void attachEncoder();
+void detachEncoder();
+void powerDown();
+void sleepUntilNextEvent();
+void handleInput();
+bool secondElapsed();
+void runTimers();
+void armCountdown();
+void countdownTask();
+void refreshTask();
+void requestFrame();
+void timeoutTask();
+void buttonTask();
+void dimTask();
+void wakeDisplay();
+void selectTimer(uint8_t slot, InputState& iS);
+void stopAlarm(KitchenTimer& kT, InputState& iS);
+bool askEncoder(EncoderQueue&, KitchenTimer&);
 bool processInput(KitchenTimer&, InputState&);
 void displayTime(KitchenTimer&, Underline);
 void setDisplayForInput(KitchenTimer& kT, InputState& iS);
-void askRtButton(ButtonSL&, KitchenTimer&, InputState&);
+void nextPreset(KitchenTimer& kT, InputState& iS);
+void rememberTime(uint8_t slot, uint16_t seconds);
+void applyCalibration(int16_t ppm);
+void calibrationCommand(int c);
+void askRtButton(ButtonEvent, KitchenTimer&, InputState&);
+void printMemory();
+void serialCommand(int c);
+perf::Wake wakeSource();
 
 //////////////////////////////////////////////////////////////////////////////
 /// @brief Initialization part of the main program
@@ -171,18 +241,39 @@ void setup(void) {
 #endif
   set_sleep_mode(SLEEP_MODE_PWR_DOWN);   // Set sleep mode to POWER DOWN mode
   sleep_enable();                        // Enable sleep mode, but not yet
+  ticker.begin();                        // Time base for the sleep during the countdown
+#ifdef SLEEPTICKER_HAS_RTC
+  SleepTick::hook = [] { scheduler.postFromIsr(task::countdown); };
+#endif
   // prepare sleepmode ready
 
-  u8g2.begin();
-#ifndef DISPLAY_Y32
-  u8g2.setFont(u8g2_font_logisoso42_tn);   // 24 Width 51 Hight
-#else
-  u8g2.setFont(u8g2_font_freedoomr25_mn);   // 19 Width 26 Hight
-#endif
+  u8g2.begin();   // The digits are pre-rendered from the fonts, setFont() is not necessary
 
   btn.begin();
-  btn.releaseOn();
-  btn.setDebounceTime_ms(100);
+  btn.onEvent = [] { scheduler.postFromIsr(task::button); };
+#ifdef TRACE
+  TimerState::hook = [](const KitchenTimer& kT) {
+    traceRing.record(trace::Event::state, timers.indexOf(kT) << 2 | static_cast<uint8_t>(kT.getState()));
+  };
+#endif
+  MilliTick::hooks[MilliTick::button] = [] { btn.tick(); };
+  attachButton(PIN_BTN);
+
+  input.encoder.begin();
+  attachEncoder();
+
+  scheduler.add(task::countdown, countdownTask);
+  scheduler.add(task::refresh, refreshTask);
+  scheduler.add(task::timeout, timeoutTask);
+  scheduler.add(task::dim, dimTask);
+  scheduler.add(task::button, buttonTask);
+  presets.begin();
+  applyCalibration(static_cast<int16_t>(presets.get(key::calibration)));
+  setDisplayForInput(timers.current(), input);   // Recalls the last used time
+#ifdef MEMORY_STATS
+  printMemory();
+#endif
+  counters.begin();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -190,101 +281,367 @@ void setup(void) {
 ///
 //////////////////////////////////////////////////////////////////////////////
 void loop() {
-  KitchenTimerState ktState {ktTimer.getState()};
+#if defined(MEMORY_STATS) || defined(PERF_STATS) || defined(TRACE) || defined(CALIBRATION)
+  if (Serial.available()) { serialCommand(Serial.read()); }
+#endif
+  traceRing.mirrorStep();
+  presets.writeStep();
+  counters.loopPass(static_cast<uint8_t>(timers.current().getState()));
+  handleInput();
+  scheduler.run();
+  sleepUntilNextEvent();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Evaluate the encoder depending on the state of the displayed timer.
+///        The button events are evaluated by buttonTask().
+///
+//////////////////////////////////////////////////////////////////////////////
+void handleInput() {
+  KitchenTimer& kT {timers.current()};
+  KitchenTimerState ktState {kT.getState()};
   switch (ktState) {
-    case KitchenTimerState::active: runTimer(ktTimer); break;
+    case KitchenTimerState::active:
+      input.steps.clear();   // The encoder has no function during the countdown
+      break;
     case KitchenTimerState::off:
-      if (processInput(ktTimer, input)) {
-        wait.start();
-      } else {
-        if (wait(TIMEOUT)) {
-          pinMode(PIN_ALARM, OUTPUT);   // Saves power
-          powerDown(PIN_BTN);
-          wait.start();                 // Start timer so that the display does not go off immediately after wake up
-          delay(1000);   // A delay so that the minute/second changeover is not triggered immediately after waking up.
-        }
-      }
+      if (processInput(kT, input)) { scheduler.after(task::timeout, TIMEOUT); }
       break;
     case KitchenTimerState::alarm:
-      !signal(melody) && signal.reset();      // plays a melody as long as signal returns true else reset sequence
-      ButtonState tmp = btn.tick();
-      if (tmp != ButtonState::notPressed) {   // Switch alarm off with encoder button
-        setDisplayForInput(ktTimer, input);
-        signal.stop();
-      }
-      if (askEncoder(input.encoder, ktTimer)) {   // Switch alarm off with encoder rotation
-        ktTimer.setSeconds(0);                    // Reset count from rotation
-        setDisplayForInput(ktTimer, input);
-        signal.stop();
+      if (askEncoder(input.steps, kT)) {   // Switch alarm off with encoder rotation
+        kT.setSeconds(0);                  // Reset count from rotation
+        stopAlarm(kT, input);
         Serial.println("ENC Alarm stop");
       }
-      wait.start();   // Start timer so that the display does not go off immediately after the alarm is turned off.
       break;
   }
-  // If the alarm is active, only the encoder query in the switch instruction may be active.
-  if (ktState != KitchenTimerState::alarm) { askRtButton(btn, ktTimer, input); }
 }
 
 //////////////////////////////////////////////////////////////////////////////
-/// @brief Interrupt service routine for wake up
+/// @brief Interrupt service routine of the button pin (both edges). It is also the wake up
+///        source of the sleep modes.
 ///
 //////////////////////////////////////////////////////////////////////////////
-void intWakeup() { detachInterrupt(PIN_BTN); }
+void intButton() { btn.edge(); }
 
 //////////////////////////////////////////////////////////////////////////////
-/// @brief  Start (and stop) the sleep mode
+/// @brief Switch on the interrupt of the button pin. The button pin of the ATMega328
+///        has no INTx, there the pin change interrupt of the port is used.
 ///
-/// @param wakeupPin     Number of the wake up interrupt pin
+/// @param pin     Number of the button pin
 //////////////////////////////////////////////////////////////////////////////
-void powerDown(uint8_t wakeupPin) {
-  // go into deep Sleep
-#if defined(__AVR_ATtiny1604__)
-  attachInterrupt(digitalPinToInterrupt(wakeupPin), intWakeup, LOW);
+void attachButton(uint8_t pin) {
+#if defined(__AVR_ATtiny1604__) || defined(__AVR_ATtiny1614__)
+  attachInterrupt(digitalPinToInterrupt(pin), intButton, CHANGE);   // Both edges wake up from all sleep modes
 #else
-  attachInterrupt(digitalPinToInterrupt(wakeupPin), intWakeup, FALLING);
+  PCIFR = _BV(digitalPinToPCICRbit(pin));   // Forget older changes
+  *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+  *digitalPinToPCICR(pin) |= _BV(digitalPinToPCICRbit(pin));
+#endif
+}
+
+#if !defined(__AVR_ATtiny1604__) && !defined(__AVR_ATtiny1614__)
+static_assert(PIN_BTN <= 7, "The interrupt of the button is PCINT2 (pins 0 - 7)");
+ISR(PCINT2_vect) { intButton(); }
 #endif
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Interrupt service routine of the encoder pins.
+///        Decoded steps are put into the queue, which is emptied by loop().
+///
+//////////////////////////////////////////////////////////////////////////////
+void intEncoder() {
+  int8_t step = input.encoder.tick();
+  if (step) {
+    input.steps.push(input.accel.detent(step, millis()));
+    traceRing.stepFromIsr(step);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Switch the encoder interrupts on or off. On the ATMega328 the encoder pins are INT0/INT1,
+///        on the ATtinys the interrupts of the PORTA pins are used.
+///
+//////////////////////////////////////////////////////////////////////////////
+void attachEncoder() {
+  attachInterrupt(digitalPinToInterrupt(PIN_IN1), intEncoder, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(PIN_IN2), intEncoder, CHANGE);
+}
+
+void detachEncoder() {
+  detachInterrupt(digitalPinToInterrupt(PIN_IN1));
+  detachInterrupt(digitalPinToInterrupt(PIN_IN2));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief  Start (and stop) the sleep mode. The controller only continues when the
+///         button driver has recognized a press, an edge alone (spike, bounce) lets it
+///         sleep again. While the driver debounces, the controller only idles, because
+///         timer 0 of the ATMega328 stops in power down.
+///         The display keeps its RAM in power save, so the last output is visible
+///         again as soon as it is switched on, without a redraw. The encoder is
+///         switched on first, steps during the wake up are queued.
+///
+//////////////////////////////////////////////////////////////////////////////
+void powerDown() {
+  traceRing.record(trace::Event::powerDown);
+  detachEncoder();   // Only the button wakes up the controller
   u8g2.setPowerSave(true);
-  delay(20);
-  sleep_cpu();   // sleep
-  // switch anything on
-  delay(20);
+  twiPump.flush();
+  counters.sleepBegin();
+  noInterrupts();
+  while (!btn.isPressed()) {
+    set_sleep_mode(btn.isActive() ? SLEEP_MODE_IDLE : SLEEP_MODE_PWR_DOWN);
+    interrupts();   // The instruction after sei is executed before a pending interrupt
+    sleep_cpu();
+    noInterrupts();
+  }
+  interrupts();
+  counters.powerDownEnd();
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  btn.ignorePress();   // The press that woke the clock does not switch the time unit
+  traceRing.record(trace::Event::wake);
+  attachEncoder();
   u8g2.setPowerSave(false);
 }
 
 //////////////////////////////////////////////////////////////////////////////
-/// @brief The set time is continuously counted down
-///        by 1 per second until the value is 0.
+/// @brief Sleep until the next event. During the countdown the controller sleeps
+///        until the next second has elapsed or the encoder button is pressed. Otherwise
+///        it idles until the next interrupt (at the latest the next millis() interrupt).
+///        As long as the button driver debounces, the controller only idles.
 ///
-/// @param kT Reference on kitchen timer object
-/// @return KitchenTimerState
-//////////////////////////////////////////////////////////////////////////////
-KitchenTimerState runTimer(KitchenTimer& kT) {
-  if (kT(SECOND)) {
-    --kT;
-    switch (kT.timeIsUp()) {
-      case false: kT.start(); break;
-      case true: kT.setState(KitchenTimerState::alarm); break;
+//////////////////////////////////////////////////////////////////////////////
+void sleepUntilNextEvent() {
+  bool deep {timers.current().getState() == KitchenTimerState::active};
+  if (deep) { Serial.flush(); }
+  // The events of the ISRs are checked with disabled interrupts, they are only enabled
+  // right before sleep_cpu() (see powerDown()). Otherwise an event between the check
+  // and the sleep would only be handled after the next wake up.
+  noInterrupts();
+  if (scheduler.timeToNext() == 0 || !input.steps.isEmpty()) {
+    interrupts();
+    return;
+  }
+  if (btn.isActive()) { deep = false; }
+#ifdef SLEEPTICKER_HAS_RTC
+  if (twiPump.isBusy()) { deep = false; }   // The TWI does not run in standby
+#endif
+  counters.sleepBegin();
+  (deep) ? ticker.sleep() : ticker.idle();
+  counters.sleepEnd(deep ? perf::Power::sleep : perf::Power::idle, wakeSource);
+}
+
+// Cause of the last wake up (PERF_STATS), a quarter turn of the encoder counts as other
+perf::Wake wakeSource() {
+  if (btn.isActive()) { return perf::Wake::button; }
+  if (!input.steps.isEmpty()) { return perf::Wake::encoder; }
+  if (ticker.isPending()) { return perf::Wake::second; }
+  return perf::Wake::other;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Checks whether the next second of the countdown has elapsed.
+///        With a RTC the seconds are counted by its interrupt (also during sleep),
+///        otherwise by millis().
+///
+/// @return true if a second has elapsed
+//////////////////////////////////////////////////////////////////////////////
+bool secondElapsed() {
+#ifdef SLEEPTICKER_HAS_RTC
+  return ticker.consume();
+#else
+  return timers(secondPeriod);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief The set times of all running timers are counted down
+///        by 1 per second until the value is 0. A timer whose time is up
+///        is displayed and its alarm is started.
+///
+//////////////////////////////////////////////////////////////////////////////
+void runTimers() {
+  if (!timers.isRunning() || !secondElapsed()) { return; }
+  timers.tick();
+  if (REFRESH.contrastIdle != 0 && idleSeconds < DIM_DELAY && ++idleSeconds == DIM_DELAY) {
+    scheduler.post(task::dim);
+  }
+  int8_t slot;
+  while ((slot = timers.popExpired()) != timers.NONE) {
+    Serial.print(F("Alarm timer "));
+    Serial.println(slot + 1);
+    timers.setCurrent(slot);
+    signal.start(melody);   // plays the melody until it is stopped
+    traceRing.record(trace::Event::melody, 1);
+#ifdef TRACE_EEPROM
+    traceRing.mirror();
+#endif
+    counters.alarm();
+    wakeDisplay();
+  }
+  if (!timers.isRunning()) { ticker.stop(); }
+  if (timers.current().getState() != KitchenTimerState::off) { scheduler.post(task::refresh); }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Arm the countdown task for the next second. With a RTC the task is posted
+///        by its interrupt, only seconds that are still pending are posted here.
+///
+//////////////////////////////////////////////////////////////////////////////
+void armCountdown() {
+#ifdef SLEEPTICKER_HAS_RTC
+  if (ticker.isPending()) { scheduler.post(task::countdown); }
+#else
+  if (timers.isRunning()) {
+    scheduler.at(task::countdown, timers.nextTick(secondPeriod));
+  } else {
+    scheduler.cancel(task::countdown);
+  }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Tasks of the scheduler
+///
+//////////////////////////////////////////////////////////////////////////////
+void countdownTask() {
+  runTimers();
+  armCountdown();
+}
+
+// The input underline is shown for a timer that is not running
+void refreshTask() {
+  scheduler.cancel(task::refresh);   // Armed by requestFrame(), but posted by another event
+  KitchenTimer& kT {timers.current()};
+  displayTime(kT, (kT.getState() == KitchenTimerState::off) ? Underline::yes : Underline::no);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Output of a changed time that has been set with the encoder. While the encoder
+///        is turned, the frames follow each other at least FRAME_INTERVAL ms apart;
+///        the steps in between only change the time, the next frame shows the sum.
+///
+//////////////////////////////////////////////////////////////////////////////
+void requestFrame() {
+  if (scheduler.isArmed(task::refresh)) { return; }
+  uint32_t since {millis() - frameStamp};
+  if (since >= FRAME_INTERVAL) {
+    scheduler.post(task::refresh);
+  } else {
+    scheduler.after(task::refresh, FRAME_INTERVAL - since);
+  }
+}
+
+void timeoutTask() {
+  if (timers.current().getState() != KitchenTimerState::off) { return; }
+  if (timers.isRunning()) {   // Show the next expiring timer instead of going to sleep
+    selectTimer(timers.nextExpiring(), input);
+    return;
+  }
+  if (presets.isBusy() || clockCalibration.isRunning()) {   // The EEPROM is only written while the clock is awake
+    scheduler.after(task::timeout, 50);
+    return;
+  }
+  FastPin<PIN_ALARM>::output();   // Saves power
+  powerDown();
+  scheduler.after(task::timeout, TIMEOUT);   // So that the display does not go off immediately after wake up
+  KitchenTimer& kT {timers.current()};
+  if (kT.timeIsUp()) {   // Recall the last used time instead of 00:00
+    setDisplayForInput(kT, input);
+    scheduler.post(task::refresh);
+  }
+}
+
+void dimTask() {
+  if (timers.current().getState() != KitchenTimerState::active) { return; }
+  u8g2.setContrast(REFRESH.contrastIdle);
+}
+
+// In the alarm state every press switches the alarm off
+void buttonTask() {
+  ButtonEvent event;
+  while (btn.pop(event)) {
+    traceRing.record(trace::Event::button, static_cast<uint8_t>(event));
+    KitchenTimer& kT {timers.current()};
+    if (kT.getState() == KitchenTimerState::alarm) {
+      stopAlarm(kT, input);
+    } else {
+      askRtButton(event, kT, input);
     }
-    displayTime(kT, Underline::no);
   }
-  return kT.getState();
 }
 
 //////////////////////////////////////////////////////////////////////////////
-/// @brief The encoder signals are evaluated
+/// @brief Restore the contrast after an input or at the alarm. While the displayed
+///        timer is running, the display is dimmed again after DIM_DELAY seconds.
+///        They are counted by runTimers(), i.e. by the seconds of the countdown:
+///        millis() stands still while the ATtinys sleep in standby, the RTC does not.
+///
+//////////////////////////////////////////////////////////////////////////////
+void wakeDisplay() {
+  if (REFRESH.contrastIdle == 0) { return; }
+  u8g2.setContrast(REFRESH.contrastActive);
+  idleSeconds = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Display another timer. A timer that is not running is displayed for input.
 ///
-/// @param enc Reference on encoder object
-/// @param kT  Reference on kitchen timer object
+/// @param slot Index of the timer
+/// @param iS Reference on input state structure
+//////////////////////////////////////////////////////////////////////////////
+void selectTimer(uint8_t slot, InputState& iS) {
+  timers.setCurrent(slot);
+  KitchenTimer& kT {timers.current()};
+  if (kT.getState() == KitchenTimerState::off) {
+    setDisplayForInput(kT, iS);   // processInput() updates the display
+  } else {
+    scheduler.post(task::refresh);
+  }
+  wakeDisplay();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Switch off the alarm of the displayed timer. If the time of another
+///        timer is also up, its alarm is displayed next.
+///
+/// @param kT Reference on kitchen timer object
+/// @param iS Reference on input state structure
+//////////////////////////////////////////////////////////////////////////////
+void stopAlarm(KitchenTimer& kT, InputState& iS) {
+  signal.stop();
+  traceRing.record(trace::Event::melody, 0);
+  counters.alarmStopped();
+  setDisplayForInput(kT, iS);
+  int8_t slot = timers.find(KitchenTimerState::alarm);
+  if (slot != timers.NONE) {
+    selectTimer(slot, iS);
+    signal.start(melody);
+    traceRing.record(trace::Event::melody, 1);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief The encoder steps queued since the last call are evaluated all at once,
+///        so that several steps only lead to one redraw of the display.
+///        The faster the encoder is turned, the more the time changes per step
+///        (ACCEL_SECONDS, ACCEL_MINUTES).
+///
+/// @param steps Reference on the queue of the encoder steps
+/// @param kT    Reference on kitchen timer object
 /// @return true  if the an encoder signal was evaluated
 /// @return false if no encoder signal was evaluated
 //////////////////////////////////////////////////////////////////////////////
-bool askEncoder(RotaryEncoder& enc, KitchenTimer& kT) {
-  uint8_t flag {true};
-  enc.tick();
-  switch (enc.getDirection()) {
-    case RotaryEncoder::Direction::NOROTATION: flag = false; break;
-    case RotaryEncoder::Direction::CLOCKWISE: ++kT; break;
-    case RotaryEncoder::Direction::COUNTERCLOCKWISE: --kT; break;
+bool askEncoder(EncoderQueue& steps, KitchenTimer& kT) {
+  bool flag {false};
+  int8_t step;
+  while (steps.pop(step)) {
+    uint8_t level = ((step > 0) ? step : -step) - 1;
+    if (level >= EncoderAccel::LEVELS) { level = EncoderAccel::LEVELS - 1; }
+    uint8_t count = (kT.getActiveUnit() == ActiveUnit::minutes) ? ACCEL_MINUTES[level] : ACCEL_SECONDS[level];
+    while (count--) { (step > 0) ? ++kT : --kT; }
+    flag = true;
   }
   return flag;
 }
@@ -305,11 +662,12 @@ bool processInput(KitchenTimer& kT, InputState& iS) {
       case InputState::state::minutes: kT.setUnitMinutes(); break;
     }
     iS.lastState = iS.currentState;
-    displayTime(kT, Underline::yes);
-  } else if (askEncoder(iS.encoder, ktTimer)) {
-    switch (ktTimer.getState()) {
-      case KitchenTimerState::alarm: ktTimer.setState(KitchenTimerState::off); break;
-      default: displayTime(kT, Underline::yes); break;
+    scheduler.post(task::refresh);
+  } else if (askEncoder(iS.steps, kT)) {
+    iS.preset = InputState::NO_PRESET;
+    switch (kT.getState()) {
+      case KitchenTimerState::alarm: kT.setState(KitchenTimerState::off); break;
+      default: requestFrame(); break;
     }
   } else {
     encoderActuated = false;
@@ -324,71 +682,147 @@ bool processInput(KitchenTimer& kT, InputState& iS) {
 /// @param iS Reference on input state structure
 //////////////////////////////////////////////////////////////////////////////
 void setDisplayForInput(KitchenTimer& kT, InputState& iS) {
-  ktTimer.setState(KitchenTimerState::off);
+  kT.setState(KitchenTimerState::off);
   iS.lastState =
       (iS.defaultState == InputState::state::seconds) ? InputState::state::minutes : InputState::state::seconds;
   iS.currentState = iS.defaultState;
+  iS.preset = InputState::NO_PRESET;
+  if (kT.timeIsUp()) { nextPreset(kT, iS); }
 }
 
 //////////////////////////////////////////////////////////////////////////////
-/// @brief Write the two time units into a string and output the string
-///        on the display.
+/// @brief Load the next stored time into the timer: first its last used time, then the
+///        presets (most recently started first), at the end 00:00. Times that are 0 or
+///        equal to the displayed or the last used time are skipped.
+///
+/// @param kT Reference on kitchen timer object
+/// @param iS Reference on input state structure
+//////////////////////////////////////////////////////////////////////////////
+void nextPreset(KitchenTimer& kT, InputState& iS) {
+  const uint16_t shown {kT.getTotalSeconds()};
+  const uint16_t lastUsed {presets.get(key::lastUsed + timers.indexOf(kT))};
+  for (uint8_t i = (iS.preset == InputState::NO_PRESET) ? 0 : iS.preset + 1; i <= PRESET_COUNT; ++i) {
+    uint16_t seconds {(i == 0) ? lastUsed : presets.get(key::preset + i - 1)};
+    if (seconds && seconds != shown && (i == 0 || seconds != lastUsed)) {
+      kT.setTotalSeconds(seconds);
+      iS.preset = i;
+      return;
+    }
+  }
+  kT.setTotalSeconds(0);
+  iS.preset = InputState::NO_PRESET;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Store the time of a started timer as its last used time and as the first
+///        preset. The EEPROM is written by presets.writeStep() in the background.
+///
+/// @param slot    Index of the timer
+/// @param seconds Time that has been started
+//////////////////////////////////////////////////////////////////////////////
+void rememberTime(uint8_t slot, uint16_t seconds) {
+  presets.put(key::lastUsed + slot, seconds);
+  uint8_t i {0};   // Each time is only once in the list
+  while (i < PRESET_COUNT - 1 && presets.get(key::preset + i) != seconds) { ++i; }
+  for (; i > 0; --i) { presets.put(key::preset + i, presets.get(key::preset + i - 1)); }
+  presets.put(key::preset, seconds);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Output the two time units on the display. Only the digits that
+///        have changed since the last output are transferred. Of a running timer
+///        only the minutes may be displayed, depending on REFRESH.
 ///
 /// @param kT Reference on kitchen timer object
 /// @param underline If Underline::yes, a line will be displayed under the digits
 ///                  active for the input. If "no", then no line is displayed.
 //////////////////////////////////////////////////////////////////////////////
 void displayTime(KitchenTimer& kT, Underline underline) {
-  char charBuffer[BUFFERLENGTH];
-  sprintf(charBuffer, "%02d:%02d", kT.getMinutes(), kT.getSeconds());
-  u8g2.firstPage();
-  do {
-    u8g2.drawStr(DISPLAY_X, DISPLAY_Y, charBuffer);   // Output string on the display.
-    if (underline == Underline::yes) {
-      if (kT.getActiveUnit() == ActiveUnit::seconds) {
-        u8g2.drawHLine(SECONDS_LINE_X, LINE_Y, LINE_WIDTH);
-      } else {
-        u8g2.drawHLine(MINUTES_LINE_X, LINE_Y, LINE_WIDTH);
-      }
-    }
-  } while (u8g2.nextPage());
+  uint32_t start {counters.frameBegin()};
+  UnderlinePos pos {UnderlinePos::none};
+  if (underline == Underline::yes) {
+    pos = (kT.getActiveUnit() == ActiveUnit::seconds) ? UnderlinePos::seconds : UnderlinePos::minutes;
+  }
+  timeDisplay.setIndicator(timers.getCurrent(), TIMER_COUNT);
+  uint16_t seconds {kT.getTotalSeconds()};
+  if (kT.getState() == KitchenTimerState::active && seconds > REFRESH.coarseAbove) {
+    timeDisplay.showMinutes((seconds + 59) / 60, !REFRESH.blinkColon || (seconds & 1));
+  } else {
+    timeDisplay.show(kT.getMinutes(), kT.getSeconds(), pos);
+  }
+  counters.frameEnd(start);
+  frameStamp = millis();
+#ifdef DISPLAY_STATS
+  Serial.print(F("Display bytes: "));
+  Serial.print(timeDisplay.getBytesLastUpdate());
+  Serial.print(F(" total: "));
+  Serial.println(timeDisplay.getBytesTotal());
+#endif
 }
 
 //////////////////////////////////////////////////////////////////////////////
-/// @brief Query of the encoder's wakeupPin function
+/// @brief Evaluation of a press of the encoder button
 ///
-/// @param b Reference on button object
+/// @param event Short or long press
 /// @param kT Reference on kitchen timer object
 /// @param iS Reference on input state structure
 //////////////////////////////////////////////////////////////////////////////
-void askRtButton(ButtonSL& b, KitchenTimer& kT, InputState& iS) {
-
-  switch (b.tick()) {
-    // If the wakeupPin is pressed for a long time, it switches between timer active and timer off.
-    case ButtonState::notPressed: break;
-    case ButtonState::longPressed:
+void askRtButton(ButtonEvent event, KitchenTimer& kT, InputState& iS) {
+  wakeDisplay();
+  switch (event) {
+    // If the button is pressed for a long time, it switches between timer active and timer off.
+    case ButtonEvent::longPress:
       if (!kT.timeIsUp()) {   // Switch on timer only if a time iS set.
-        tone(PIN_ALARM, note::a6, 30);
+        Buzzer::play(note::a6, 30);
         switch (kT.getState()) {
-          case KitchenTimerState::active: setDisplayForInput(ktTimer, input); break;
+          case KitchenTimerState::active:
+            timers.stop(timers.getCurrent());
+            setDisplayForInput(kT, iS);
+            if (!timers.isRunning()) { ticker.stop(); }
+            armCountdown();
+            break;
           case KitchenTimerState::off:
-            kT.setState(KitchenTimerState::active);
-            kT.setUnitSeconds();
-            displayTime(kT, Underline::no);   // Delete underline
-            kT.start();                       // Start the countdown
+            rememberTime(timers.getCurrent(), kT.getTotalSeconds());
+            iS.preset = InputState::NO_PRESET;
+            clockCalibration.cancel(ticker);   // Uses the ticker with the RTC
+            if (!timers.isRunning()) { ticker.start(); }
+            timers.start(timers.getCurrent());   // Start the countdown
+            armCountdown();
+            scheduler.post(task::refresh);       // Delete underline
+            wakeDisplay();                       // Arms the dimming
             break;
           case KitchenTimerState::alarm: break;
         }
+      } else if (TIMER_COUNT > 1) {   // A long press at 00:00 selects the next timer
+        // Only at 00:00: a stopped timer with a time has no gesture to select another
+        // timer, it is turned to 00:00 or started first (README).
+        Buzzer::play(note::a6, 30);
+        selectTimer((timers.getCurrent() + 1) % TIMER_COUNT, iS);
+      }
+      break;
+    case ButtonEvent::shortPress:
+      if (kT.getState() == KitchenTimerState::active) {   // A short press on a running timer selects the next timer
+        if (TIMER_COUNT > 1) {
+          Buzzer::play(note::a6, 30);
+          selectTimer((timers.getCurrent() + 1) % TIMER_COUNT, iS);
+        }
+        break;
+      }
+      // The recalled time is unchanged: next preset. Also right after a wake up, which recalls the
+      // last used time, so the unit is switched only after a turn or the last preset (README).
+      if (iS.preset != InputState::NO_PRESET) {
+        Buzzer::play(note::a6, 30);
+        nextPreset(kT, iS);
+        scheduler.post(task::refresh);
+        break;
       }
-    case ButtonState::shortPressed:
-      if (kT.getState() == KitchenTimerState::active) { break; }
       switch (iS.currentState) {
         case InputState::state::seconds:
-          tone(PIN_ALARM, note::a6, 30);
+          Buzzer::play(note::a6, 30);
           iS.currentState = InputState::state::minutes;
           break;
         case InputState::state::minutes:
-          tone(PIN_ALARM, note::a6, 30);
+          Buzzer::play(note::a6, 30);
           iS.currentState = InputState::state::seconds;
           break;
         default: break;
@@ -397,3 +831,128 @@ void askRtButton(ButtonSL& b, KitchenTimer& kT, InputState& iS) {
     default: break;
   }
 }
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Correction of the time base of the countdown, once at the start and after a
+///        calibration. With the RTC, SleepTicker shortens or lengthens its period, otherwise
+///        the period of a second on millis() is changed. Either way the tick itself stays
+///        one addition.
+///
+/// @param ppm    Deviation of the time base (positive = fast), 0 = not calibrated
+//////////////////////////////////////////////////////////////////////////////
+void applyCalibration(int16_t ppm) {
+#ifdef SLEEPTICKER_HAS_RTC
+  ticker.calibrate(ppm);
+#else
+  // 256000 * (1 + ppm / 1000000) = 256000 + ppm * 0.256
+  secondPeriod = (ppm) ? periodQ8(1000) + static_cast<int32_t>(ppm) * 32 / 125 : SECOND;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Calibration via Serial (CALIBRATION), see tools/calibrate.py:
+///        'k' first mark, 'K' second mark followed by the time between the marks in ms
+///        according to the PC and a line end. The deviation is stored in the EEPROM and
+///        applied immediately. 'c' prints the stored deviation.
+///        Only possible while no timer is running. A 'K' without a measurement started
+///        by 'k' is answered with "CAL ERROR" and nothing is stored.
+///
+/// @param c      Received character
+//////////////////////////////////////////////////////////////////////////////
+void calibrationCommand(int c) {
+  static uint32_t referenceMs {0};
+  static bool marked {false};   // 'K' received, the reference time follows
+  switch (c) {
+    case 'k':
+      marked = false;
+      if (timers.isRunning()) {
+        Serial.println(F("CAL BUSY"));
+        break;
+      }
+      clockCalibration.start(ticker);
+      Serial.println(F("CAL START"));
+      break;
+    case 'K':
+      if (!clockCalibration.isRunning()) {
+        marked = false;
+        Serial.println(F("CAL ERROR"));
+        break;
+      }
+      clockCalibration.stop(ticker);
+      referenceMs = 0;
+      marked = true;
+      break;
+    case '\n': {
+      if (!marked) { break; }
+      marked = false;
+      int16_t ppm;
+      if (!clockCalibration.result(referenceMs, ppm)) {
+        Serial.println(F("CAL ERROR"));
+        break;
+      }
+      int16_t stored = (ppm) ? ppm : 1;   // 0 means not calibrated, 1ppm makes no difference
+      presets.put(key::calibration, static_cast<uint16_t>(stored));
+      applyCalibration(stored);
+      Serial.print(F("CAL "));
+      Serial.println(ppm);
+      break;
+    }
+    case 'c':
+      Serial.print(F("CAL "));
+      Serial.println(static_cast<int16_t>(presets.get(key::calibration)));
+      break;
+    default:
+      if (marked && c >= '0' && c <= '9') { referenceMs = referenceMs * 10 + (c - '0'); }
+      break;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Output of the RAM usage (lib/MemoryMonitor) and of the size of the global objects.
+///        The stack maximum is the high-water mark since the start.
+///
+//////////////////////////////////////////////////////////////////////////////
+void printMemory() {
+  memory::print(Serial);
+  MEMORY_OBJECT(Serial, u8g2);
+  MEMORY_OBJECT(Serial, timeDisplay);
+  MEMORY_OBJECT(Serial, twiPump);
+  MEMORY_OBJECT(Serial, input);
+  MEMORY_OBJECT(Serial, btn);
+  MEMORY_OBJECT(Serial, scheduler);
+  MEMORY_OBJECT(Serial, timers);
+  MEMORY_OBJECT(Serial, ticker);
+  MEMORY_OBJECT(Serial, signal);
+  MEMORY_OBJECT(Serial, presets);
+  MEMORY_OBJECT(Serial, Serial);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief Commands via Serial: 'm' RAM usage (MEMORY_STATS), 'p' performance counters (PERF_STATS),
+///        't' trace and 'e' its copy in the EEPROM (TRACE), 'k', 'K', 'c' calibration (CALIBRATION)
+///
+/// @param c      Received character
+//////////////////////////////////////////////////////////////////////////////
+void serialCommand(int c) {
+  switch (c) {
+#ifdef MEMORY_STATS
+    case 'm': printMemory(); break;
+#endif
+#ifdef PERF_STATS
+    case 'p': counters.print(Serial); break;
+#endif
+#ifdef TRACE
+    case 't': traceRing.print(Serial); break;
+    case 'e': traceRing.printMirror(Serial); break;
+#endif
+    default:
+#ifdef CALIBRATION
+      calibrationCommand(c);
+#endif
+      break;
+  }
+}
+
+#ifdef KITCHENCLOCK_BENCH
+  #include "Benchmark.hpp"   // Cycle measurements in simavr instead of loop()
+#endif
@@ -0,0 +1,99 @@
+#
+# Benchmark runner (PlatformIO extra_scripts, target "bench")
+#
+# Runs the program built with KITCHENCLOCK_BENCH (src/Benchmark.hpp) in simavr and
+# writes the measured CPU cycles and the resulting times of the scenarios to
+# benchmarks/<env>.json. The file is sorted and stable, so a regression shows up in
+# the diff between two builds. A check that reports errors ("CHECK <name> <errors>", e.g.
+# the pre-rendered glyphs against the U8g2 font) fails the target.
+#
+# simavr does not simulate the tinyAVR series (ATtiny1604/1614). Their program runs on the
+# board instead: it waits for a line end on Serial, which bench.py sends to the serial port
+# (monitor_port of the environment), and the results are read from there.
+#
+#   pio run -e bench_nanoatmega328 -t bench
+#   pio run -e bench_ATtiny1604 -t upload -t bench
+#   bench.py <firmware.elf> <mcu> <f_cpu> <output.json> [serial port]   (without PlatformIO)
+#
+import json
+import os
+import re
+import subprocess
+
+TIMEOUT = 120   # Seconds of host time
+BAUD = 115200   # Serial.begin() of main.cpp
+RESULT = re.compile(r"BENCH (\w+) (\d+)")
+CHECK = re.compile(r"CHECK (\w+) (\d+)")
+ANSI = re.compile(r"\x1b\[[0-9;]*m")
+
+
+def simulate(elf, mcu, f_cpu):
+    proc = subprocess.run(["simavr", "-m", mcu, "-f", str(f_cpu), elf], stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT, timeout=TIMEOUT, universal_newlines=True)
+    return ANSI.sub("", proc.stdout)
+
+
+def receive(port):
+    import serial   # pyserial, installed with PlatformIO
+    output = ""
+    with serial.Serial(port, BAUD, timeout=TIMEOUT) as link:
+        link.reset_input_buffer()
+        link.write(b"\n")
+        while "BENCH END" not in output:
+            line = link.readline().decode("ascii", "replace")
+            if not line:
+                break   # Timeout
+            output += line
+    return output
+
+
+def run(elf, mcu, f_cpu, port=None):
+    output = receive(port) if port else simulate(elf, mcu, f_cpu)
+    if "BENCH END" not in output:
+        raise RuntimeError("The benchmark did not finish:\n" + output)
+    failed = ["%s (%s errors)" % check for check in CHECK.findall(output) if int(check[1]) != 0]
+    if failed:
+        raise RuntimeError("Check failed: " + ", ".join(failed))
+    return {name: int(cycles) for name, cycles in RESULT.findall(output)}
+
+
+def write(results, mcu, f_cpu, target):
+    report = {
+        "mcu": mcu,
+        "f_cpu": f_cpu,
+        "scenarios": {name: {"cycles": cycles, "us": round(cycles * 1e6 / f_cpu, 2)}
+                      for name, cycles in results.items()},
+    }
+    os.makedirs(os.path.dirname(os.path.abspath(target)), exist_ok=True)
+    with open(target, "w") as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+        f.write("\n")
+    for name in sorted(results):
+        print("%-20s %10d cycles %12.2f us" % (name, results[name], report["scenarios"][name]["us"]))
+
+
+def bench(elf, mcu, f_cpu, target, port=None):
+    write(run(elf, mcu, f_cpu, port), mcu, f_cpu, target)
+
+
+try:
+    Import("env")   # noqa: F821
+except NameError:   # Called outside of PlatformIO
+    import sys
+    bench(sys.argv[1], sys.argv[2], int(sys.argv[3]), sys.argv[4], sys.argv[5] if len(sys.argv) > 5 else None)
+else:
+    def bench_action(target, source, env):
+        port = None
+        if env.subst("$PIOPLATFORM") == "atmelmegaavr":   # tinyAVR: on the board
+            port = env.GetProjectOption("monitor_port", "")
+            if not port:
+                raise RuntimeError("Set monitor_port to the serial adapter of the board")
+        bench(str(source[0]), env.BoardConfig().get("build.mcu"), int(env.subst("$BOARD_F_CPU").rstrip("L")),
+              os.path.join(env.subst("$PROJECT_DIR"), "benchmarks", env.subst("$PIOENV") + ".json"), port)
+
+    env.AddCustomTarget(   # noqa: F821
+        name="bench",
+        dependencies="$BUILD_DIR/${PROGNAME}.elf",
+        actions=bench_action,
+        title="Benchmark",
+        description="Measure the hot paths in simavr or on the board")
@@ -0,0 +1,58 @@
+#
+# Calibration of the countdown clock against the clock of the PC (CALIBRATION in main.cpp)
+#
+# Sends a 'k' as the first mark, waits, and sends a 'K' as the second mark followed by the time
+# between the two marks in ms according to the PC. The kitchen clock measures the same time with
+# the time base of its countdown (millis() on the ATMega328, the RTC on the ATtinys), stores the
+# deviation in ppm in the EEPROM and applies it from now on. Both marks are single bytes that are
+# sent right after the time is taken, so their delay through the USB cancels out.
+#
+#   calibrate.py <port> [seconds]   (default 600, e.g. calibrate.py /dev/ttyUSB0 1800)
+#
+# The clock must be awake (press the button) and no timer may run; it stays awake until the end.
+# The PC clock should be synchronized via NTP, the longer the measurement, the smaller the error
+# of the Serial transfer (1ms in 600s = 1.7ppm). Requires pyserial.
+#
+import sys
+import time
+
+import serial
+
+BAUD = 115200
+
+
+def answer(port, timeout):
+    end = time.monotonic() + timeout
+    while time.monotonic() < end:
+        line = port.readline().decode("ascii", "replace").strip()
+        if line.startswith("CAL"):
+            return line
+    return None
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit("calibrate.py <port> [seconds]")
+    seconds = int(sys.argv[2]) if len(sys.argv) > 2 else 600
+    with serial.Serial(sys.argv[1], BAUD, timeout=1) as port:
+        time.sleep(2)   # Opening the port may reset the ATMega328
+        port.reset_input_buffer()
+        start = time.monotonic()
+        port.write(b"k")
+        line = answer(port, 5)
+        if line != "CAL START":
+            sys.exit("No calibration mode: %s" % line)
+        print("Measuring for %d s ..." % seconds)
+        time.sleep(seconds - (time.monotonic() - start))
+        elapsed = time.monotonic() - start
+        port.write(b"K")
+        port.write(b"%d\n" % round(elapsed * 1000))
+        line = answer(port, 5)
+        if line is None or line == "CAL ERROR":
+            sys.exit("Calibration failed: %s" % line)
+        ppm = int(line.split()[1])
+        print("Deviation %+d ppm (%+.1f s per hour), stored" % (ppm, ppm * 3600e-6))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,225 @@
+#
+# Pre-build script (PlatformIO extra_scripts)
+#
+# Renders the digits 0-9 and ':' of the U8g2 fonts used by the kitchen clock into
+# page aligned column bitmaps (8 vertical pixels per byte, like the display RAM of the
+# SSD1306/SH1106) and writes them as PROGMEM tables, one struct per variant (font and display
+# lines). DigitGlyphs.h declares the structs, the font traits of lib/TimeDisplay/DisplayPolicy.hpp
+# refer to them. The tables are defined once in DigitGlyphs.cpp, which is compiled with the
+# program, so the header can be included by any number of translation units.
+# TimeDisplay copies these bytes directly into the page buffer, so the font decoder of
+# U8g2 is not needed at runtime. The first and last column with pixels of each glyph
+# limit the transfer of a changed cell to the tile columns that really change.
+#
+# The cells are as wide as the advance (dx) of the glyphs, so TimeDisplay places them exactly
+# like drawStr() does: WIDTH is the advance of the digits (the same for all of them, the fonts
+# are monospaced for digits), COLON_WIDTH the one of ':'. A glyph with pixels outside of its
+# advance would overlap its neighbour and is rejected.
+#
+# The layout of DisplayPolicy computes the baseline the same way as render_variant() and
+# checks it by static_assert. Tables of variants that are not used are removed by the linker
+# (--gc-sections).
+#
+import codecs
+import os
+import re
+
+VARIANTS = [
+    # (struct, font, display lines, font height)
+    ("Logisoso42", "u8g2_font_logisoso42_tn", 64, 51),
+    ("Freedoomr25", "u8g2_font_freedoomr25_mn", 32, 26),
+    # Other options for 32 lines: u8g2_font_inb21_mn (18 x 27), u8g2_font_logisoso20_tn (13 x 26)
+]
+GLYPHS = "0123456789:"
+FONT_HEADER_SIZE = 23
+
+
+def load_font(source, name):
+    match = re.search(r"\b" + name + r"\[\d*\][^=]*=\s*((?:\"(?:[^\"\\]|\\.)*\"\s*)+);", source)
+    if not match:
+        raise RuntimeError("Font %s not found" % name)
+    data = b""
+    for chunk in re.findall(r"\"((?:[^\"\\]|\\.)*)\"", match.group(1)):
+        data += codecs.decode(chunk, "unicode_escape").encode("latin-1")
+    return data
+
+
+class BitReader:
+    def __init__(self, data, pos):
+        self.data = data
+        self.pos = pos
+        self.bit = 0
+
+    def unsigned(self, cnt):
+        val = 0
+        for i in range(cnt):
+            val |= ((self.data[self.pos] >> self.bit) & 1) << i
+            self.bit += 1
+            if self.bit == 8:
+                self.bit = 0
+                self.pos += 1
+        return val
+
+    def signed(self, cnt):
+        return self.unsigned(cnt) - (1 << (cnt - 1))
+
+
+def decode_glyph(font, char):
+    """Returns (width, height, x offset, y offset, advance, set of pixels) of a glyph"""
+    bits_0, bits_1, bits_w, bits_h, bits_x, bits_y, bits_dx = font[2:9]
+    pos = FONT_HEADER_SIZE
+    while font[pos] != 0:
+        if font[pos] == ord(char):
+            break
+        pos += font[pos + 1]
+    else:
+        raise RuntimeError("Glyph '%s' is not part of the font" % char)
+    reader = BitReader(font, pos + 2)
+    w = reader.unsigned(bits_w)
+    h = reader.unsigned(bits_h)
+    x = reader.signed(bits_x)
+    y = reader.signed(bits_y)
+    dx = reader.signed(bits_dx)
+    pixels = set()
+    px = py = 0
+
+    def run(length, foreground):
+        nonlocal px, py
+        for _ in range(length):
+            if foreground:
+                pixels.add((px, py))
+            px += 1
+            if px == w:
+                px = 0
+                py += 1
+
+    while w > 0 and py < h:
+        zeros = reader.unsigned(bits_0)
+        ones = reader.unsigned(bits_1)
+        while True:
+            run(zeros, False)
+            run(ones, True)
+            if reader.unsigned(1) == 0:
+                break
+    return w, h, x, y, dx, pixels
+
+
+def render_variant(font, lines, height):
+    baseline = (lines - 1 + height) // 2   # DisplayPolicy::Y
+    top = lines - 1
+    bottom = 0
+    glyphs = []
+    advances = []
+    for char in GLYPHS:
+        w, h, x, y, dx, pixels = decode_glyph(font, char)
+        if char != ":" and advances and dx != advances[0]:
+            raise RuntimeError("The digits of the font have different advances (%d, %d)" % (advances[0], dx))
+        advances.append(dx)
+        screen = set()
+        for (gx, gy) in pixels:
+            col = x + gx
+            row = baseline - (h + y) + gy
+            if not (0 <= col < dx) or not (0 <= row < lines):
+                raise RuntimeError("Glyph '%s' does not fit into its cell" % char)
+            screen.add((col, row))
+            top = min(top, row)
+            bottom = max(bottom, row)
+        glyphs.append(screen)
+    first_page = top // 8
+    pages = bottom // 8 - first_page + 1
+    width = advances[0]
+    tables = []
+    for screen in glyphs:   # ':' is padded to WIDTH, TimeDisplay copies only COLON_WIDTH columns
+        rows = []
+        for page in range(first_page, first_page + pages):
+            rows.append([sum(1 << bit for bit in range(8) if (col, page * 8 + bit) in screen)
+                         for col in range(width)])
+        tables.append(rows)
+    return baseline, first_page, pages, width, advances[-1], tables
+
+
+def write_if_changed(target, content):
+    if os.path.isfile(target):
+        with open(target, "r") as f:
+            if f.read() == content:
+                return
+    with open(target, "w") as f:
+        f.write(content)
+
+
+def generate(font_source, header):
+    """Writes the header and the source file with the same name (.cpp)"""
+    with open(font_source, "r") as f:
+        source = f.read()
+    generated = "// Generated by tools/glyph_cache.py from %s - do not edit" % os.path.basename(font_source)
+    out = [
+        generated,
+        "#pragma once",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "namespace glyph {",
+        "constexpr char CHARACTERS[] {\"%s\"};" % GLYPHS,
+    ]
+    tables_out = [
+        generated,
+        "#include \"%s\"" % os.path.basename(header),
+        "",
+        "namespace glyph {",
+    ]
+    for struct, name, lines, height in VARIANTS:
+        font = load_font(source, name)
+        baseline, first_page, pages, width, colon_width, tables = render_variant(font, lines, height)
+        print("glyph_cache: %s %d bytes flash (bitmaps and ink), the font for drawStr() %d bytes"
+              % (struct, len(GLYPHS) * (pages * width + 2), len(font)))
+        out += [
+            "",
+            "// %s for %d display lines" % (name, lines),
+            "struct %s {" % struct,
+            "  static constexpr uint8_t LINES {%d};" % lines,
+            "  static constexpr uint8_t WIDTH {%d};         // Advance of the digits" % width,
+            "  static constexpr uint8_t COLON_WIDTH {%d};   // Advance of ':'" % colon_width,
+            "  static constexpr uint8_t HEIGHT {%d};" % height,
+            "  static constexpr uint8_t BASELINE {%d};" % baseline,
+            "  static constexpr uint8_t FIRST_PAGE {%d};   // First display page (8 pixel lines) with glyph pixels"
+            % first_page,
+            "  static constexpr uint8_t PAGES {%d};" % pages,
+            "  static const uint8_t bitmaps[%d][PAGES][WIDTH];" % len(GLYPHS),
+            "  static const uint8_t ink[%d][2];   // First and last column with pixels" % len(GLYPHS),
+            "};",
+        ]
+        tables_out += [
+            "",
+            "const uint8_t %s::bitmaps[%d][%s::PAGES][%s::WIDTH] PROGMEM {" % (struct, len(GLYPHS), struct, struct),
+        ]
+        for char, rows in zip(GLYPHS, tables):
+            tables_out.append("  {   // '%s'" % char)
+            for row in rows:
+                tables_out.append("    {" + ", ".join("0x%02X" % b for b in row) + "},")
+            tables_out.append("  },")
+        tables_out.append("};")
+        tables_out.append("const uint8_t %s::ink[%d][2] PROGMEM {" % (struct, len(GLYPHS)))
+        for char, rows in zip(GLYPHS, tables):
+            cols = [col for col in range(width) if any(row[col] for row in rows)]
+            tables_out.append("  {%d, %d},   // '%s'" % (cols[0], cols[-1], char))
+        tables_out.append("};")
+    out += ["}   // namespace glyph", ""]
+    tables_out += ["}   // namespace glyph", ""]
+    write_if_changed(header, "\n".join(out))
+    write_if_changed(os.path.splitext(header)[0] + ".cpp", "\n".join(tables_out))
+
+
+try:
+    Import("env")   # noqa: F821
+except NameError:   # Called outside of PlatformIO: glyph_cache.py <u8g2_fonts.c> <DigitGlyphs.h>
+    if __name__ == "__main__":   # Not when imported by tools/glyph_check.py
+        import sys
+        generate(sys.argv[1], sys.argv[2])
+else:
+    gen_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")   # noqa: F821
+    os.makedirs(gen_dir, exist_ok=True)
+    fonts = os.path.join(env.subst("$PROJECT_LIBDEPS_DIR"), env.subst("$PIOENV"),   # noqa: F821
+                         "U8g2", "src", "clib", "u8g2_fonts.c")
+    generate(fonts, os.path.join(gen_dir, "DigitGlyphs.h"))
+    env.Append(CPPPATH=[gen_dir])   # noqa: F821
+    env.BuildSources(os.path.join("$BUILD_DIR", "glyphs"), gen_dir)   # noqa: F821  DigitGlyphs.cpp
@@ -0,0 +1,126 @@
+#
+# Pre-build script of env:native (PlatformIO extra_scripts)
+#
+# Checks the digits pre-rendered by tools/glyph_cache.py against U8g2 itself: the C library
+# of the installed (pinned) U8g2 is compiled with the host compiler, draws the times below
+# with u8g2_DrawStr() into a full frame buffer at the baseline of DisplayPolicy, and every
+# byte of the buffer is compared with the tables placed at the advances of the glyphs, like
+# TimeDisplay places its cells. A difference fails the build. The same comparison runs on
+# the target in the benchmark (src/Benchmark.hpp), this one needs no simavr.
+#
+# The fonts are copied verbatim from u8g2_fonts.c into the test program, so the C compiler
+# reads them and not the parser of glyph_cache.py. The library is compiled once per build
+# directory (u8g2_check/libu8g2.a).
+#
+#   glyph_check.py <U8g2/src/clib> <work dir> [cc]   (without PlatformIO)
+#
+import glob
+import os
+import re
+import subprocess
+import sys
+
+TEXTS = ["01:23", "45:67", "89:00", "::::"]
+WIDTH = 128   # Columns of the panels
+SETUP = {   # Full buffer setup per display lines, the controller does not matter for the buffer
+    64: "u8g2_Setup_ssd1306_i2c_128x64_noname_f",
+    32: "u8g2_Setup_ssd1306_i2c_128x32_univision_f",
+}
+FONT_SOURCES = ("u8g2_fonts.c", "u8x8_fonts.c")   # Not needed in the library, only slow to compile
+
+
+def font_declaration(source, name):
+    match = re.search(r"^const uint8_t " + name + r"\[\d*\][^=]*=\s*(?:\"(?:[^\"\\]|\\.)*\"\s*)+;", source,
+                      re.MULTILINE)
+    if not match:
+        raise RuntimeError("Font %s not found" % name)
+    return match.group(0)
+
+
+def build_library(clib, work, cc):
+    library = os.path.join(work, "libu8g2.a")
+    if os.path.isfile(library):
+        return library
+    objects = []
+    for source in sorted(glob.glob(os.path.join(clib, "*.c"))):
+        if os.path.basename(source) in FONT_SOURCES:
+            continue
+        obj = os.path.join(work, os.path.basename(source)[:-2] + ".o")
+        subprocess.check_call([cc, "-c", "-O1", "-w", "-I", clib, "-o", obj, source])
+        objects.append(obj)
+    subprocess.check_call(["ar", "rcs", library] + objects)
+    return library
+
+
+def test_program(fonts, variants):
+    out = ["#include <stdio.h>", "#include \"u8g2.h\"", ""]
+    out += [font_declaration(fonts, name) for _, name, _, _ in variants]
+    out += ["", "static void dump(u8g2_t* u8g2, const uint8_t* font, int baseline, const char* text) {",
+            "  u8g2_ClearBuffer(u8g2);",
+            "  u8g2_SetFont(u8g2, font);",
+            "  u8g2_DrawStr(u8g2, 0, baseline, text);",
+            "  const uint8_t* buffer = u8g2_GetBufferPtr(u8g2);",
+            "  int size = u8g2_GetBufferTileHeight(u8g2) * u8g2_GetBufferTileWidth(u8g2) * 8;",
+            "  for (int i = 0; i < size; ++i) { printf(\"%02X\", buffer[i]); }",
+            "  printf(\"\\n\");",
+            "}", "", "int main(void) {", "  u8g2_t u8g2;"]
+    for _, name, lines, baseline in variants:
+        out.append("  %s(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);" % SETUP[lines])
+        out += ["  dump(&u8g2, %s, %d, \"%s\");" % (name, baseline, text) for text in TEXTS]
+    out += ["  return 0;", "}", ""]
+    return "\n".join(out)
+
+
+def expected_buffer(rendered, lines, text):
+    baseline, first_page, pages, width, colon_width, tables = rendered
+    buffer = bytearray(lines // 8 * WIDTH)
+    x = 0
+    for char in text:
+        idx = glyph_cache.GLYPHS.index(char)
+        for page in range(pages):
+            for col in range(width):
+                if tables[idx][page][col] and x + col < WIDTH:
+                    buffer[(first_page + page) * WIDTH + x + col] |= tables[idx][page][col]
+        x += colon_width if char == ":" else width
+    return buffer
+
+
+def check(clib, work, cc="cc"):
+    os.makedirs(work, exist_ok=True)
+    with open(os.path.join(clib, "u8g2_fonts.c"), "r") as f:
+        fonts = f.read()
+    variants = []
+    rendered = {}
+    for struct, name, lines, height in glyph_cache.VARIANTS:
+        rendered[struct] = glyph_cache.render_variant(glyph_cache.load_font(fonts, name), lines, height)
+        variants.append((struct, name, lines, rendered[struct][0]))
+    program = os.path.join(work, "glyph_check.c")
+    with open(program, "w") as f:
+        f.write(test_program(fonts, variants))
+    binary = os.path.join(work, "glyph_check")
+    subprocess.check_call([cc, "-O1", "-w", "-I", clib, "-o", binary, program, build_library(clib, work, cc)])
+    dumps = subprocess.check_output([binary], universal_newlines=True).split()
+    errors = []
+    for struct, name, lines, _ in variants:
+        for text in TEXTS:
+            drawn = bytes.fromhex(dumps.pop(0))
+            expected = expected_buffer(rendered[struct], lines, text)
+            wrong = sum(1 for a, b in zip(drawn, expected) if a != b) + abs(len(drawn) - len(expected))
+            if wrong:
+                errors.append("%s \"%s\": %d bytes differ" % (name, text, wrong))
+    if errors:
+        raise RuntimeError("The pre-rendered glyphs differ from U8g2:\n  " + "\n  ".join(errors))
+    print("glyph_check: %d times drawn by U8g2 match the pre-rendered glyphs" % (len(variants) * len(TEXTS)))
+
+
+try:
+    Import("env")   # noqa: F821
+except NameError:   # Called outside of PlatformIO
+    sys.path.insert(0, os.path.dirname(os.path.abspath(sys.argv[0])))
+    import glyph_cache
+    check(*sys.argv[1:])
+else:
+    sys.path.insert(0, os.path.join(env.subst("$PROJECT_DIR"), "tools"))   # noqa: F821
+    import glyph_cache
+    check(os.path.join(env.subst("$PROJECT_LIBDEPS_DIR"), env.subst("$PIOENV"), "U8g2", "src", "clib"),   # noqa: F821
+          os.path.join(env.subst("$BUILD_DIR"), "u8g2_check"), env.subst("$CC"))   # noqa: F821
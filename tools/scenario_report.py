@@ -0,0 +1,64 @@
+#
+# Results of the regression scenarios (test/scenarios) in the native simulation
+#
+# Runs the program of env:native with each script and writes the figures of its summary to
+# benchmarks/native.json: loop passes, sleeps, tones, frames and bytes to the display, bytes
+# and busy time of the TWI, wake up times and the longest time from a short press to its
+# action. The simulation is deterministic (virtual time, seeded random inputs), so the file
+# only changes with the program and shows up in the diff like the cycle counts of
+# tools/bench.py. The host time is left out. The exit code is 1 if a scenario failed.
+#
+#   pio run -e native && python tools/scenario_report.py
+#   scenario_report.py [program] [output.json]
+#
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+
+PROJECT = os.path.dirname(os.path.dirname(os.path.abspath(sys.argv[0])))
+SUMMARY = [   # (pattern, names of the groups)
+    (r"(\d+) loop passes, ([\d.]+)s simulated, (\d+) sleeps, (\d+) tones, (\d+) tiles",
+     ("loop_passes", "simulated_s", "sleeps", "tones", "tiles")),
+    (r"Display: (\d+) frames, (\d+) bytes, ([\d.]+)s on, mean contrast (\d+)",
+     ("frames", "display_bytes", "display_on_s", "mean_contrast")),
+    (r"TWI: (\d+) bytes, ([\d.]+)s busy, (\d+) input interrupts during transfers",
+     ("twi_bytes", "twi_busy_s", "inputs_during_transfers")),
+    (r"Wake ups: (\d+), to the first frame max ([\d.]+)ms, to the first display update max ([\d.]+)ms",
+     ("wake_ups", "wake_first_frame_ms", "wake_first_update_ms")),
+    (r"Short presses: (\d+) with action, release to action max ([\d.]+)ms", ("short_presses", "press_action_ms")),
+]
+
+
+def number(text):
+    return float(text) if "." in text else int(text)
+
+
+def run(program, script):
+    proc = subprocess.run([program, "--quiet", script], stdout=subprocess.PIPE, universal_newlines=True)
+    result = {"passed": proc.returncode == 0}
+    for pattern, names in SUMMARY:
+        match = re.search(pattern, proc.stdout)
+        if match:
+            result.update(zip(names, map(number, match.groups())))
+    return result
+
+
+def report(program, target):
+    scenarios = {}
+    for script in sorted(glob.glob(os.path.join(PROJECT, "test", "scenarios", "*.txt"))):
+        scenarios[os.path.basename(script)] = run(program, script)
+    with open(target, "w") as f:
+        json.dump({"program": "native", "scenarios": scenarios}, f, indent=2, sort_keys=True)
+        f.write("\n")
+    failed = [name for name, result in scenarios.items() if not result["passed"]]
+    for name in failed:
+        print("%s failed" % name)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(report(sys.argv[1] if len(sys.argv) > 1 else os.path.join(PROJECT, ".pio", "build", "native", "program"),
+                    sys.argv[2] if len(sys.argv) > 2 else os.path.join(PROJECT, "benchmarks", "native.json")))
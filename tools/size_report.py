@@ -0,0 +1,71 @@
+#
+# Size report after the build (PlatformIO extra_scripts, post)
+#
+# Lists the static RAM (.data + .bss) per object from the symbol table of the firmware,
+# the largest first, the space that remains for the stack and the flash (.text + .data).
+# The report is printed and written to sizes/<env>.txt, so a growing object shows up in the
+# diff between two builds, and the environments of the display variants (platformio.ini)
+# can be compared. The stack high-water mark at runtime is printed by the program with
+# MEMORY_STATS (main.cpp).
+#
+#   size_report.py <firmware.elf> <ram bytes> <flash bytes> <output.txt> [nm]   (without PlatformIO)
+#
+import os
+import subprocess
+
+STACK_RESERVE = 128   # Bytes, less remaining RAM is marked as a warning
+RAM_TYPES = "bBdD"    # nm symbol types of .bss and .data
+FLASH_SECTIONS = (".text", ".data")   # .data is copied from the flash at the start
+
+
+def objects(elf, nm):
+    output = subprocess.check_output([nm, "--size-sort", "--reverse-sort", "-S", "-C", elf],
+                                     universal_newlines=True)
+    result = []
+    for line in output.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) == 4 and fields[2] in RAM_TYPES:
+            result.append((int(fields[1], 16), fields[3]))
+    return result
+
+
+def flash_used(elf, size_tool):
+    output = subprocess.check_output([size_tool, "-A", elf], universal_newlines=True)
+    used = 0
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in FLASH_SECTIONS:
+            used += int(fields[1])
+    return used
+
+
+def write(symbols, ram, flash, flash_size, target):
+    used = sum(size for size, _ in symbols)
+    lines = ["%6d  %s" % (size, name) for size, name in symbols]
+    lines.append("%6d  static RAM of %d bytes" % (used, ram))
+    lines.append("%6d  remain for the stack%s" % (ram - used, "  (WARNING)" if ram - used < STACK_RESERVE else ""))
+    lines.append("%6d  flash of %d bytes" % (flash, flash_size))
+    os.makedirs(os.path.dirname(os.path.abspath(target)), exist_ok=True)
+    with open(target, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    print("\n".join(lines))
+
+
+def report(elf, ram, flash_size, target, nm="avr-nm"):
+    write(objects(elf, nm), ram, flash_used(elf, nm[:-2] + "size"), flash_size, target)
+
+
+try:
+    Import("env")   # noqa: F821
+except NameError:   # Called outside of PlatformIO
+    import sys
+    report(sys.argv[1], int(sys.argv[2]), int(sys.argv[3]), sys.argv[4], *sys.argv[5:6])
+else:
+    def report_action(target, source, env):
+        board = env.BoardConfig()
+        report(str(target[0]), int(board.get("upload.maximum_ram_size")), int(board.get("upload.maximum_size")),
+               os.path.join(env.subst("$PROJECT_DIR"), "sizes", env.subst("$PIOENV") + ".txt"),
+               env.subst("$CC").replace("gcc", "nm"))
+
+    if env.subst("$PIOPLATFORM") != "native":   # noqa: F821
+        env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", report_action)   # noqa: F821
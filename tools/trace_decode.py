@@ -0,0 +1,97 @@
+#
+# Decoder of the trace ring (lib/TraceRing, TRACE in main.cpp)
+#
+# Reads a Serial log that contains the output of 't' (trace) or 'e' (copy in the EEPROM)
+# and prints each trace as a timeline. Other lines of the log are ignored.
+#
+#   trace_decode.py [log]   (without log from stdin, e.g. pio device monitor | tee log)
+#
+# The records only contain the lower 16 bits of millis(), the upper bits are written as a
+# separate record when they change. For the records before the first of these, the upper
+# bits are taken from the time of the output or are one less than the first time record;
+# such times are marked with ~ (unless the output was within the first 65s). millis() does not count in power down, so the times are
+# the awake time since the start.
+#
+import re
+import sys
+
+HEADER = re.compile(r"TRACE (START|EEPROM) (\d+)(?: (\d+))?$")
+RECORD = re.compile(r"^[0-9a-f]{8}$")
+
+TIME, STATE, STEP, BUTTON, POWER_DOWN, WAKE, MELODY = range(7)   # trace::Event
+STATES = ["off", "active", "alarm"]                                 # KitchenTimerState
+BUTTON_EVENTS = ["short press", "long press"]                       # ButtonEvent
+
+
+def describe(event, arg):
+    if event == STATE:
+        return "timer %d %s" % ((arg >> 2) + 1, STATES[arg & 3] if (arg & 3) < len(STATES) else "?")
+    if event == STEP:
+        return "encoder %+d" % (arg - 256 if arg > 127 else arg)
+    if event == BUTTON:
+        return "button " + (BUTTON_EVENTS[arg] if arg < len(BUTTON_EVENTS) else "?")
+    if event == POWER_DOWN:
+        return "power down"
+    if event == WAKE:
+        return "wake up"
+    if event == MELODY:
+        return "melody " + ("start" if arg else "stop")
+    return "unknown event %d (%d)" % (event, arg)
+
+
+def timeline(records, now=None):
+    highs = [time for time, event, _ in records if event == TIME]
+    if highs:
+        high = highs[0] - 1
+    else:
+        high = (now >> 16) if now is not None else 0
+    exact = not highs and now is not None and high == 0   # No time record has been written yet
+    lines = []
+    for time, event, arg in records:
+        if event == TIME:
+            high = time
+            exact = True
+            continue
+        seconds = ((high << 16) | time) / 1000.0
+        lines.append("%s%10.3f s  %s" % (" " if exact else "~", seconds, describe(event, arg)))
+    return lines
+
+
+def decode(lines):
+    result = []
+    block = None
+    for line in lines:
+        text = line.strip()
+        if not text.startswith("TRACE"):
+            continue
+        if text == "TRACE END":
+            if block is not None:
+                result.append(block)
+            block = None
+            continue
+        match = HEADER.match(text)
+        if match:
+            eeprom = match.group(1) == "EEPROM"
+            block = {"eeprom": eeprom, "now": None if eeprom else int(match.group(2)), "records": []}
+            continue
+        if block is not None:
+            for token in text.split()[1:]:
+                if RECORD.match(token):
+                    value = int(token, 16)
+                    block["records"].append((value >> 16, (value >> 8) & 0xFF, value & 0xFF))
+    return result
+
+
+def main():
+    source = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    for block in decode(source):
+        if block["eeprom"]:
+            print("Trace from the EEPROM (%d records)" % len(block["records"]))
+        else:
+            print("Trace at %.3f s (%d records)" % (block["now"] / 1000.0, len(block["records"])))
+        for line in timeline(block["records"], block["now"]):
+            print(line)
+
+
+if __name__ == "__main__":
+    main()